@@ -0,0 +1,73 @@
+#include <ctime>
+#include <string_view>
+#include <papilio/papilio.hpp>
+#include <papilio/accessor/chrono.hpp>
+#include <papilio/formatter/chrono.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+// The lookup used by accessors before attribute tables
+int find_by_compare(const papilio::attribute_name& attr)
+{
+    using namespace std::literals;
+
+    constexpr std::string_view names[] = {
+        "year"sv, "month"sv, "mday"sv, "hour"sv, "min"sv, "sec"sv, "wday"sv, "yday"sv, "is_dst"sv
+    };
+
+    for(int i = 0; i < 9; ++i)
+    {
+        if(attr == names[i])
+            return i;
+    }
+
+    return -1;
+}
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000'000;
+
+    using tm_accessor = papilio::accessor<std::tm, papilio::format_context>;
+
+    const papilio::attribute_name attrs[] = {"year", "yday", "is_dst", "unknown"};
+
+    papilio::println("Finding attributes");
+
+    papilio_bench::run(
+        "string comparisons",
+        iterations,
+        [&]
+        {
+            for(const auto& attr : attrs)
+                papilio_bench::do_not_optimize(find_by_compare(attr));
+        }
+    );
+
+    papilio_bench::run(
+        "attribute_table::find",
+        iterations,
+        [&]
+        {
+            for(const auto& attr : attrs)
+                papilio_bench::do_not_optimize(tm_accessor::attributes.find(attr));
+        }
+    );
+
+    std::tm t{};
+    t.tm_year = 124;
+    t.tm_yday = 100;
+
+    papilio::println("Formatting chained access");
+
+    papilio_bench::run(
+        "format(\"{0.year}-{0.yday}-{0.is_dst}\")",
+        iterations / 4,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::format("{0.year}-{0.yday}-{0.is_dst}", t));
+        }
+    );
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include <iterator>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+// Output iterator hiding the container,
+// so the output can only be written character by character.
+class push_back_iterator
+{
+public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    push_back_iterator() noexcept = default;
+
+    explicit push_back_iterator(std::string& str) noexcept
+        : m_str(&str) {}
+
+    push_back_iterator& operator=(char ch)
+    {
+        m_str->push_back(ch);
+        return *this;
+    }
+
+    push_back_iterator& operator*() noexcept
+    {
+        return *this;
+    }
+
+    push_back_iterator& operator++() noexcept
+    {
+        return *this;
+    }
+
+    push_back_iterator operator++(int) noexcept
+    {
+        return *this;
+    }
+
+private:
+    std::string* m_str = nullptr;
+};
+
+template <typename... Args>
+void compare(
+    std::string_view name,
+    std::size_t iterations,
+    papilio::format_string<const Args&...> fmt,
+    const Args&... args
+)
+{
+    std::string buf;
+    const std::size_t bytes = papilio::format(fmt, args...).size();
+
+    papilio_bench::run_throughput(
+        papilio::format("{} (per character)", name),
+        iterations,
+        bytes,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(push_back_iterator(buf), fmt, args...);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run_throughput(
+        papilio::format("{} (bulk)", name),
+        iterations,
+        bytes,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), fmt, args...);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 100'000;
+
+    papilio::println("Appending to a container by a single insertion vs. character by character");
+
+    const std::string long_str(4096, 'x');
+
+    compare(
+        "literal",
+        iterations,
+        "The quick brown fox jumps over the lazy dog. "
+        "The quick brown fox jumps over the lazy dog. "
+        "The quick brown fox jumps over the lazy dog. {}",
+        42
+    );
+    compare("fill", iterations, "{:*^512}", "centered");
+    compare("string", iterations, "{}", long_str);
+}
@@ -0,0 +1,68 @@
+#include <chrono>
+#include <string>
+#include <papilio/papilio.hpp>
+#include <papilio/formatter/chrono.hpp>
+#include "benchmark.hpp"
+#if __has_include(<format>)
+#    include <format>
+#endif
+
+int main()
+{
+    using namespace std::chrono;
+    using namespace std::chrono_literals;
+
+    constexpr std::size_t iterations = 100'000;
+
+    const auto tp = sys_days(2024y / 3 / 5) + 7h + 8min + 9s + 12ms;
+
+    papilio::println("Formatting timestamps");
+
+    std::string buf;
+    papilio::chrono::enable_timestamp_cache(false);
+    papilio_bench::run(
+        "direct",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), "{:%F %T}", tp);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio::chrono::enable_timestamp_cache(true);
+    papilio_bench::run(
+        "direct, cached second",
+        iterations,
+        [&, i = 0]() mutable
+        {
+            buf.clear();
+            // Increasing time points within the same second
+            papilio::format_to(std::back_inserter(buf), "{:%F %T}", tp + milliseconds(i++ % 900));
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run(
+        "stream (L)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), "{:L%F %T}", tp);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+
+#if defined(__cpp_lib_format) && __cpp_lib_format >= 201907L
+    papilio_bench::run(
+        "std::format",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            std::format_to(std::back_inserter(buf), "{:%F %T}", tp);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+#endif
+}
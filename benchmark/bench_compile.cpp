@@ -0,0 +1,88 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000'000;
+
+    papilio::println("Compiled format string vs. papilio::format");
+
+    {
+        constexpr std::string_view fmt = "Processing item {} of {} ({:.1f}%): {}";
+        const papilio::compiled_format compiled(fmt);
+
+        papilio_bench::run(
+            "format (mixed)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(fmt, 42, 100, 42.0, "ok");
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+        papilio_bench::run(
+            "compiled_format (mixed)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(compiled, 42, 100, 42.0, "ok");
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+    }
+
+    {
+        constexpr std::string_view fmt = "[{level:>5}] {file}:{line}: {msg}";
+        const papilio::compiled_format compiled(fmt);
+
+        using namespace papilio::literals;
+
+        papilio_bench::run(
+            "format (named)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(
+                    fmt, "level"_a = "INFO", "file"_a = "main.cpp", "line"_a = 42, "msg"_a = "hello world"
+                );
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+        papilio_bench::run(
+            "compiled_format (named)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(
+                    compiled, "level"_a = "INFO", "file"_a = "main.cpp", "line"_a = 42, "msg"_a = "hello world"
+                );
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+    }
+
+    {
+        constexpr std::string_view fmt = "There {$ {0} != 1 ? 'are' : 'is'} {0} apple{$ {0} != 1 ? 's'} in the basket.";
+        const papilio::compiled_format compiled(fmt);
+
+        papilio_bench::run(
+            "format (script)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(fmt, 3);
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+        papilio_bench::run(
+            "compiled_format (script)",
+            iterations,
+            [&]
+            {
+                auto str = papilio::format(compiled, 3);
+                papilio_bench::do_not_optimize(str);
+            }
+        );
+    }
+}
@@ -0,0 +1,47 @@
+#include <string>
+#include <vector>
+#include <random>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+void bench(
+    std::string_view name,
+    std::size_t iterations,
+    const std::vector<double>& values,
+    papilio::format_string<const double&> fmt
+)
+{
+    std::string buf;
+    papilio_bench::run(
+        name,
+        iterations,
+        [&]
+        {
+            buf.clear();
+            for(const double& val : values)
+                papilio::format_to(std::back_inserter(buf), fmt, val);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000;
+
+    papilio::println("Formatting 1024 doubles");
+
+    std::mt19937_64 gen(42);
+    std::lognormal_distribution<double> dist(0.0, 8.0);
+    std::vector<double> values;
+    for(std::size_t i = 0; i < 1024; ++i)
+        values.push_back(dist(gen));
+
+    bench("\"{}\"", iterations, values, "{}");
+    bench("\"{:.3f}\"", iterations, values, "{:.3f}");
+    bench("\"{:E}\"", iterations, values, "{:E}");
+    bench("\"{:>16.3f}\"", iterations, values, "{:>16.3f}");
+}
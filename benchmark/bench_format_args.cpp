@@ -0,0 +1,59 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 200'000;
+
+    const std::string name = "request";
+    const char* fmt = "{} {} {} {} {} {} {} {}";
+
+    papilio::println(
+        "sizeof(format_arg) = {}, sizeof(format_arg::handle) = {}",
+        sizeof(papilio::format_arg),
+        sizeof(papilio::format_arg::handle)
+    );
+
+    papilio_bench::run(
+        "make_format_args (8 arguments)",
+        iterations,
+        [&]
+        {
+            auto args = papilio::make_format_args(1, 2u, 3LL, 4.0, 5.0f, true, 'c', name);
+            papilio_bench::do_not_optimize(args);
+        }
+    );
+
+    papilio_bench::run(
+        "format (8 arguments)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::vformat(
+                fmt,
+                papilio::make_format_args(1, 2u, 3LL, 4.0, 5.0f, true, 'c', name)
+            ));
+        }
+    );
+
+    papilio_bench::run(
+        "dynamic_format_args (8 arguments)",
+        iterations,
+        [&]
+        {
+            papilio::dynamic_format_args args(1, 2u, 3LL, 4.0, 5.0f, true, 'c', name);
+            papilio_bench::do_not_optimize(args);
+        }
+    );
+
+    papilio_bench::run(
+        "format_capture (8 arguments)",
+        iterations,
+        [&]
+        {
+            papilio::format_capture cap("{} {} {} {} {} {} {} {}", 1, 2u, 3LL, 4.0, 5.0f, true, 'c', name);
+            papilio_bench::do_not_optimize(cap);
+        }
+    );
+}
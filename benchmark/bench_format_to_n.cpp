@@ -0,0 +1,56 @@
+#include <string>
+#include <vector>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000;
+
+    const std::string huge_str(10 * 1024 * 1024, 'x');
+    const std::vector<int> huge_vec(1'000'000, 42);
+
+    papilio::println("Formatting huge arguments into a buffer of 256 characters");
+
+    char buf[256];
+
+    papilio_bench::run(
+        "format_to_n(10 MiB string)",
+        iterations,
+        [&]
+        {
+            auto result = papilio::format_to_n(buf, sizeof(buf), "msg={}", huge_str);
+            papilio_bench::do_not_optimize(result);
+        }
+    );
+
+    papilio_bench::run(
+        "format_to_n(10 MiB string, with width)",
+        iterations,
+        [&]
+        {
+            auto result = papilio::format_to_n(buf, sizeof(buf), "msg={:>16}", huge_str);
+            papilio_bench::do_not_optimize(result);
+        }
+    );
+
+    papilio_bench::run(
+        "format_to_n(10^6 integers)",
+        iterations,
+        [&]
+        {
+            auto result = papilio::format_to_n(buf, sizeof(buf), "data={}", huge_vec);
+            papilio_bench::do_not_optimize(result);
+        }
+    );
+
+    papilio_bench::run(
+        "format_to_n(join of 10^6 integers)",
+        iterations,
+        [&]
+        {
+            auto result = papilio::format_to_n(buf, sizeof(buf), "data={}", papilio::join(huge_vec, ","));
+            papilio_bench::do_not_optimize(result);
+        }
+    );
+}
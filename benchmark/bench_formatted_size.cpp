@@ -0,0 +1,44 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 200'000;
+
+    const std::string name = "temperature sensor";
+
+    papilio::println("Calculating the size of formatted results");
+
+    papilio_bench::run(
+        "format(...).size()",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::format(
+                "{}: id={:#x} count={:>12} value={} {}",
+                name,
+                0xdeadbeef,
+                123456789,
+                -987654321LL,
+                4294967295u
+            ));
+        }
+    );
+
+    papilio_bench::run(
+        "formatted_size(...)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::formatted_size(
+                "{}: id={:#x} count={:>12} value={} {}",
+                name,
+                0xdeadbeef,
+                123456789,
+                -987654321LL,
+                4294967295u
+            ));
+        }
+    );
+}
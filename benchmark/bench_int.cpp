@@ -0,0 +1,98 @@
+#include <string>
+#include <vector>
+#include <random>
+#include <charconv>
+#include <cstdint>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+template <typename T>
+std::vector<T> make_values(std::size_t count)
+{
+    std::mt19937_64 gen(42);
+    std::vector<T> values;
+    values.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        // Various number of digits
+        const unsigned int shift = static_cast<unsigned int>(gen() % (sizeof(T) * 8));
+        values.push_back(static_cast<T>(gen() >> (64 - sizeof(T) * 8 + shift)));
+    }
+
+    return values;
+}
+
+template <typename T>
+void compare(std::string_view name, std::size_t iterations)
+{
+    const std::vector<T> values = make_values<T>(1024);
+    std::string buf;
+
+    papilio_bench::run(
+        papilio::format("{} std::to_chars", name),
+        iterations,
+        [&]
+        {
+            char tmp[64];
+            buf.clear();
+            for(T val : values)
+            {
+                auto result = std::to_chars(tmp, tmp + 64, val);
+                buf.append(tmp, result.ptr);
+            }
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run(
+        papilio::format("{} papilio \"{{}}\"", name),
+        iterations,
+        [&]
+        {
+            buf.clear();
+            for(T val : values)
+                papilio::format_to(std::back_inserter(buf), "{}", val);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+
+    papilio_bench::run(
+        papilio::format("{} std::to_chars (hex)", name),
+        iterations,
+        [&]
+        {
+            char tmp[64];
+            buf.clear();
+            for(T val : values)
+            {
+                auto result = std::to_chars(tmp, tmp + 64, val, 16);
+                buf.append(tmp, result.ptr);
+            }
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run(
+        papilio::format("{} papilio \"{{:x}}\"", name),
+        iterations,
+        [&]
+        {
+            buf.clear();
+            for(T val : values)
+                papilio::format_to(std::back_inserter(buf), "{:x}", val);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000;
+
+    papilio::println("Formatting 1024 integers");
+
+    compare<std::int32_t>("int32", iterations);
+    compare<std::int64_t>("int64", iterations);
+    compare<std::uint64_t>("uint64", iterations);
+}
@@ -0,0 +1,73 @@
+#include <string>
+#include <locale>
+#include <chrono>
+#include <papilio/papilio.hpp>
+#include <papilio/formatter/chrono.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+// Punctuation like the de_DE locale
+class de_numpunct : public std::numpunct<char>
+{
+protected:
+    char do_decimal_point() const override
+    {
+        return ',';
+    }
+
+    char do_thousands_sep() const override
+    {
+        return '.';
+    }
+
+    std::string do_grouping() const override
+    {
+        return "\3";
+    }
+};
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 200'000;
+
+    const std::locale loc(std::locale::classic(), new de_numpunct);
+    std::string buf;
+
+    papilio::println("Locale-aware formatting with the same locale");
+
+    papilio_bench::run(
+        "format_to(loc, \"{:L}\", int)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), loc, "{:L}", 1234567890);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+
+    papilio_bench::run(
+        "format_to(loc, \"{:.2Lf}\", double)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), loc, "{:.2Lf}", 1234567.891);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+
+    const auto tp = std::chrono::sys_seconds(std::chrono::seconds(1'700'000'000));
+    papilio_bench::run(
+        "format_to(loc, \"{:L%c}\", sys_seconds)",
+        iterations / 10,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), loc, "{:L%c}", tp);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
@@ -0,0 +1,32 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 1'000'000;
+
+    papilio::println("Formatting a short message into a new string vs. a reused memory buffer");
+
+    papilio_bench::run(
+        "format",
+        iterations,
+        []
+        {
+            std::string result = papilio::format("{}: {:>8.3f} ({})", "value", 3.14159, 42);
+            papilio_bench::do_not_optimize(result);
+        }
+    );
+
+    papilio::memory_buffer buf;
+    papilio_bench::run(
+        "format_to(memory_buffer&)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(buf, "{}: {:>8.3f} ({})", "value", 3.14159, 42);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
@@ -0,0 +1,93 @@
+#include <string>
+#include <map>
+#include <vector>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 50'000;
+    constexpr int field_count = 32;
+
+    std::vector<std::string> names;
+    std::string fmt;
+    for(int i = 0; i < field_count; ++i)
+    {
+        names.push_back("notification_field_" + std::to_string(i));
+        fmt += '{';
+        fmt += names.back();
+        fmt += "} ";
+    }
+
+    papilio::dynamic_format_args args;
+    for(int i = 0; i < field_count; ++i)
+        args.emplace(papilio::arg(std::string_view(names[i]), i));
+
+    // Node-based lookup used by the previous implementation, for reference
+    std::map<std::string, papilio::format_arg, std::less<>> map_args;
+    for(int i = 0; i < field_count; ++i)
+        map_args.emplace(names[i], papilio::format_arg(i));
+
+    papilio::println("Formatting a template with {} named arguments", field_count);
+
+    papilio_bench::run(
+        "vformat(fmt, dynamic_format_args)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::vformat(fmt, args));
+        }
+    );
+
+    papilio_bench::run(
+        "dynamic_format_args::get(name)",
+        iterations,
+        [&]
+        {
+            for(const std::string& n : names)
+                papilio_bench::do_not_optimize(args.get(std::string_view(n)));
+        }
+    );
+
+    papilio_bench::run(
+        "std::map<std::string, format_arg>::find(name)",
+        iterations,
+        [&]
+        {
+            for(const std::string& n : names)
+                papilio_bench::do_not_optimize(map_args.find(std::string_view(n))->second);
+        }
+    );
+
+    papilio_bench::run(
+        "format(\"{a} {b} {c} {d}\", arg(name, v)...)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::format(
+                "{a} {b} {c} {d}",
+                papilio::arg("a", 1),
+                papilio::arg("b", 2),
+                papilio::arg("c", 3),
+                papilio::arg("d", 4)
+            ));
+        }
+    );
+
+    papilio_bench::run(
+        "format(\"{a} {b} {c} {d}\", \"name\"_a = v...)",
+        iterations,
+        [&]
+        {
+            using namespace papilio::literals;
+
+            papilio_bench::do_not_optimize(papilio::format(
+                "{a} {b} {c} {d}",
+                "a"_a = 1,
+                "b"_a = 2,
+                "c"_a = 3,
+                "d"_a = 4
+            ));
+        }
+    );
+}
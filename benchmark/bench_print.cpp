@@ -0,0 +1,38 @@
+#include <cstdio>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 200'000;
+
+    std::FILE* file = std::tmpfile();
+    if(!file)
+        return 1;
+
+    papilio::println("Printing lines to a file");
+
+    papilio_bench::run(
+        "println(file, ...)",
+        iterations,
+        [&]
+        {
+            papilio::println(file, "[{}] {}: {:.3f}", 42, "value", 3.14159);
+        }
+    );
+
+    {
+        papilio::async_sink sink(file, 1 << 16, papilio::async_sink::overflow_policy::grow);
+        papilio_bench::run(
+            "async_sink::println(...)",
+            iterations,
+            [&]
+            {
+                sink.println("[{}] {}: {:.3f}", 42, "value", 3.14159);
+            }
+        );
+        sink.flush();
+    }
+
+    std::fclose(file);
+}
@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 20;
+    constexpr std::size_t count = 100'000;
+
+    std::mt19937 gen(42);
+    std::vector<int> ints;
+    std::vector<double> doubles;
+    ints.reserve(count);
+    doubles.reserve(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        ints.push_back(static_cast<int>(gen()));
+        doubles.push_back(std::uniform_real_distribution<double>(-1e6, 1e6)(gen));
+    }
+
+    papilio::println("Formatting ranges of {} values", count);
+
+    std::string buf;
+
+    papilio_bench::run(
+        "int (element-wise)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            bool first = true;
+            for(int val : ints)
+            {
+                if(!first)
+                    buf += ", ";
+                first = false;
+                papilio::format_to(std::back_inserter(buf), "{}", val);
+            }
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run(
+        "int (range)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), "{:n}", ints);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+
+    papilio_bench::run(
+        "double (element-wise)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            bool first = true;
+            for(double val : doubles)
+            {
+                if(!first)
+                    buf += ", ";
+                first = false;
+                papilio::format_to(std::back_inserter(buf), "{:.3f}", val);
+            }
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+    papilio_bench::run(
+        "double (range)",
+        iterations,
+        [&]
+        {
+            buf.clear();
+            papilio::format_to(std::back_inserter(buf), "{:n:.3f}", doubles);
+            papilio_bench::do_not_optimize(buf);
+        }
+    );
+}
@@ -0,0 +1,39 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+int main()
+{
+    constexpr std::size_t iterations = 200'000;
+
+    const std::string name = "file";
+
+    papilio::println("Executing scripted fields");
+
+    auto bench = [&](const char* label)
+    {
+        papilio_bench::run(
+            label,
+            iterations,
+            [&]
+            {
+                for(int n : {0, 1, 5})
+                {
+                    papilio_bench::do_not_optimize(papilio::format(
+                        "{0} {$ {0} == 0 ? 'no' : $ {0} > 1 ? 'many' : 'one'} {1}{$ {0} != 1 ? 's'}, "
+                        "{$ !{0} ? 'empty' : {2:>8}}",
+                        n,
+                        name,
+                        n * 1024
+                    ));
+                }
+            }
+        );
+    };
+
+    papilio::script_base::enable_script_cache(false);
+    bench("interpreted");
+
+    papilio::script_base::enable_script_cache(true);
+    bench("compiled and cached");
+}
@@ -0,0 +1,55 @@
+#include <string>
+#include <ostream>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+// Only supports formatting by operator<<
+struct log_record
+{
+    int id;
+    std::string message;
+
+    friend std::ostream& operator<<(std::ostream& os, const log_record& rec)
+    {
+        os << '#' << rec.id << ' ' << rec.message;
+        return os;
+    }
+};
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 100'000;
+
+    log_record rec{42, std::string(200, 'x')};
+    papilio::println("Formatting a type supporting only operator<<");
+
+    papilio_bench::run(
+        "format(\"{}\", rec)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::format("{}", rec));
+        }
+    );
+
+    papilio_bench::run(
+        "format(\"{:>240}\", rec)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::format("{:>240}", rec));
+        }
+    );
+
+    papilio_bench::run(
+        "formatted_size(\"{}\", rec)",
+        iterations,
+        [&]
+        {
+            papilio_bench::do_not_optimize(papilio::formatted_size("{}", rec));
+        }
+    );
+}
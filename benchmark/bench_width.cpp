@@ -0,0 +1,68 @@
+#include <string>
+#include <papilio/papilio.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+void compare(std::string_view name, std::size_t iterations, std::string_view str)
+{
+    papilio_bench::run_throughput(
+        papilio::format("{} (per code point)", name),
+        iterations,
+        str.size(),
+        [&]
+        {
+            std::size_t width = 0;
+            for(papilio::utf::codepoint cp : papilio::utf::string_ref(str))
+                width += cp.estimate_width();
+            papilio_bench::do_not_optimize(width);
+        }
+    );
+    papilio_bench::run_throughput(
+        papilio::format("{} (string)", name),
+        iterations,
+        str.size(),
+        [&]
+        {
+            std::size_t width = papilio::utf::estimate_width(str);
+            papilio_bench::do_not_optimize(width);
+        }
+    );
+}
+} // namespace
+
+int main()
+{
+    constexpr std::size_t iterations = 10'000;
+
+    papilio::println("Estimating display width of strings");
+
+    std::string ascii;
+    std::string mixed;
+    for(int i = 0; i < 64; ++i)
+    {
+        ascii += "The quick brown fox jumps over the lazy dog. ";
+        mixed += "Name: 中文名字 | Café | \U0001f351 ";
+    }
+
+    compare("ASCII", iterations, ascii);
+    compare("mixed CJK/ASCII", iterations, mixed);
+
+    std::string table;
+    papilio_bench::run(
+        "padded table row",
+        iterations * 10,
+        [&]
+        {
+            table.clear();
+            papilio::format_to(
+                std::back_inserter(table),
+                "|{:<12}|{:^12}|{:>12}|",
+                "中文名字",
+                "Café",
+                "ASCII text"
+            );
+            papilio_bench::do_not_optimize(table);
+        }
+    );
+}
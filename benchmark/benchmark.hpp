@@ -0,0 +1,82 @@
+#ifndef PAPILIO_BENCHMARK_BENCHMARK_HPP
+#define PAPILIO_BENCHMARK_BENCHMARK_HPP
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <papilio/print.hpp>
+
+namespace papilio_bench
+{
+#ifdef PAPILIO_COMPILER_MSVC
+inline const void* volatile do_not_optimize_sink = nullptr;
+#endif
+
+// Prevents the compiler from optimizing away the result.
+template <typename T>
+void do_not_optimize(const T& val) noexcept
+{
+#ifdef PAPILIO_COMPILER_MSVC
+    do_not_optimize_sink = &val;
+#else
+    asm volatile("" : : "g"(&val) : "memory");
+#endif
+}
+
+/**
+ * @brief Run the function repeatedly.
+ *
+ * @return double Nanoseconds per iteration
+ */
+template <typename Func>
+double measure(std::size_t iterations, Func&& func)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Warm up
+    for(std::size_t i = 0; i < iterations / 10 + 1; ++i)
+        func();
+
+    const auto start = clock::now();
+    for(std::size_t i = 0; i < iterations; ++i)
+        func();
+    const auto stop = clock::now();
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           static_cast<double>(iterations);
+}
+
+/**
+ * @brief Run the function repeatedly and print the average time of each iteration.
+ *
+ * @return double Nanoseconds per iteration
+ */
+template <typename Func>
+double run(std::string_view name, std::size_t iterations, Func&& func)
+{
+    const double ns = papilio_bench::measure(iterations, func);
+    papilio::println("{:<48}{:>12.2f} ns/iter", name, ns);
+
+    return ns;
+}
+
+/**
+ * @brief Run the function repeatedly and print the throughput.
+ *
+ * @param bytes Bytes of output produced by each iteration
+ * @return double Bytes per second
+ */
+template <typename Func>
+double run_throughput(std::string_view name, std::size_t iterations, std::size_t bytes, Func&& func)
+{
+    const double ns = papilio_bench::measure(iterations, func);
+    const double bytes_per_sec = static_cast<double>(bytes) / ns * 1e9;
+    papilio::println("{:<48}{:>12.2f} MiB/s", name, bytes_per_sec / (1024.0 * 1024.0));
+
+    return bytes_per_sec;
+}
+} // namespace papilio_bench
+
+#endif
@@ -4,6 +4,9 @@
 #pragma once
 
 #include <variant>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 #include "fmtfwd.hpp"
 #include "utility.hpp"
 #include "utf/codepoint.hpp"
@@ -119,9 +122,54 @@ private:
     variant_type m_val;
 };
 
+namespace detail
+{
+    inline constexpr std::uint32_t attribute_hash_basis = 2166136261u;
+
+    // Adds a code unit to the hash, so parsers can compute the id while scanning the name.
+    template <typename CharT>
+    constexpr std::uint32_t attribute_hash_step(std::uint32_t h, CharT ch) noexcept
+    {
+        h ^= static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<CharT>>(ch));
+        return h * 16777619u;
+    }
+
+    // FNV-1a hash of the code units of an attribute name.
+    // Names in attribute tables are ASCII, so their ids are the same for all character types.
+    template <typename CharT>
+    constexpr std::uint32_t attribute_hash(std::basic_string_view<CharT> name) noexcept
+    {
+        std::uint32_t h = attribute_hash_basis;
+        for(CharT ch : name)
+            h = attribute_hash_step(h, ch);
+
+        return h;
+    }
+
+    template <typename CharT>
+    constexpr bool attribute_name_equal(std::string_view ascii_name, std::basic_string_view<CharT> name) noexcept
+    {
+        if(ascii_name.size() != name.size())
+            return false;
+
+        for(std::size_t i = 0; i < name.size(); ++i)
+        {
+            using uchar_t = std::make_unsigned_t<CharT>;
+            if(static_cast<std::uint32_t>(static_cast<unsigned char>(ascii_name[i])) !=
+               static_cast<std::uint32_t>(static_cast<uchar_t>(name[i])))
+                return false;
+        }
+
+        return true;
+    }
+} // namespace detail
+
 /**
  * @brief Attribute name of a format argument.
  *
+ * The id of the name is computed once on construction, so accessors using @ref attribute_table
+ * can find the attribute by comparing integers.
+ *
  * @tparam CharT Character type
  */
 PAPILIO_EXPORT template <typename CharT>
@@ -139,19 +187,31 @@ public:
 
     template <basic_string_like<CharT> String>
     basic_attribute_name(String&& str) noexcept(std::is_nothrow_constructible_v<string_container_type, String>)
-        : m_name(std::forward<String>(str))
+        : m_name(std::forward<String>(str)), m_id(calc_id())
     {}
 
     template <basic_string_like<CharT> String>
     basic_attribute_name(independent_t, String&& str) noexcept(std::is_nothrow_constructible_v<string_container_type, String>)
-        : m_name(independent, std::forward<String>(str))
+        : m_name(independent, std::forward<String>(str)), m_id(calc_id())
     {}
 
     template <typename... Args>
     basic_attribute_name(std::in_place_t, Args&&... args)
-        : m_name(std::forward<Args>(args)...)
+        : m_name(std::forward<Args>(args)...), m_id(calc_id())
     {}
 
+    /**
+     * @brief Construct from a name and its id computed by the parser of format strings.
+     *
+     * @note The id must be the same as the one computed from the name.
+     */
+    template <basic_string_like<CharT> String>
+    basic_attribute_name(String&& str, std::uint32_t id) noexcept(std::is_nothrow_constructible_v<string_container_type, String>)
+        : m_name(std::forward<String>(str)), m_id(id)
+    {
+        PAPILIO_ASSERT(m_id == calc_id());
+    }
+
     bool operator==(const basic_attribute_name& rhs) const noexcept = default;
 
     friend bool operator==(const basic_attribute_name& lhs, const string_type& rhs) noexcept
@@ -190,6 +250,17 @@ public:
         return m_name;
     }
 
+    /**
+     * @brief Get the id of the name.
+     *
+     * Equal names have the same id. Different names may have the same id, too.
+     */
+    [[nodiscard]]
+    std::uint32_t id() const noexcept
+    {
+        return m_id;
+    }
+
     operator string_view_type() const noexcept
     {
         return static_cast<string_view_type>(m_name);
@@ -197,8 +268,119 @@ public:
 
 private:
     string_container_type m_name;
+    std::uint32_t m_id;
+
+    std::uint32_t calc_id() const noexcept
+    {
+        return detail::attribute_hash(static_cast<string_view_type>(m_name));
+    }
+};
+
+/**
+ * @brief Attribute names known at compile time.
+ *
+ * Accessors can declare their attributes in a table and dispatch on the index returned by `find()`.
+ * The lookup compares the ids of names before comparing the strings.
+ *
+ * @code{.cpp}
+ * static constexpr attribute_table attributes{"size", "length"};
+ *
+ * switch(attributes.find(attr))
+ * {
+ * case attributes.index_of("size"):
+ *     return val.size();
+ * case attributes.index_of("length"):
+ *     return val.length();
+ * default:
+ *     throw_invalid_attribute(attr);
+ * }
+ * @endcode
+ *
+ * @tparam N Number of attributes
+ */
+PAPILIO_EXPORT template <std::size_t N>
+class attribute_table
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Construct the table from ASCII names.
+     */
+    template <std::convertible_to<std::string_view>... Names>
+    requires(sizeof...(Names) == N)
+    consteval attribute_table(const Names&... names)
+        : m_names{std::string_view(names)...}
+    {
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            for(char ch : m_names[i])
+            {
+                if(static_cast<unsigned char>(ch) >= 128)
+                    throw format_error("attribute names must be ASCII");
+            }
+            m_ids[i] = detail::attribute_hash(m_names[i]);
+        }
+    }
+
+    [[nodiscard]]
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]]
+    constexpr std::string_view operator[](std::size_t i) const noexcept
+    {
+        return m_names[i];
+    }
+
+    /**
+     * @brief Get the index of a name in the table at compile time.
+     *
+     * It is ill-formed if the name is not in the table.
+     */
+    [[nodiscard]]
+    consteval std::size_t index_of(std::string_view name) const
+    {
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            if(m_names[i] == name)
+                return i;
+        }
+
+        throw format_error("attribute not found");
+    }
+
+    /**
+     * @brief Find an attribute name.
+     *
+     * @return The index of the name in the table, or `npos` if not found.
+     */
+    template <typename CharT>
+    [[nodiscard]]
+    constexpr std::size_t find(const basic_attribute_name<CharT>& attr) const noexcept
+    {
+        const std::uint32_t id = attr.id();
+        for(std::size_t i = 0; i < N; ++i)
+        {
+            if(m_ids[i] != id)
+                continue;
+            if(detail::attribute_name_equal(m_names[i], static_cast<std::basic_string_view<CharT>>(attr)))
+                return i;
+        }
+
+        return npos;
+    }
+
+private:
+    std::array<std::string_view, N> m_names;
+    std::array<std::uint32_t, N> m_ids{};
 };
 
+PAPILIO_EXPORT template <typename... Names>
+attribute_table(const Names&...) -> attribute_table<sizeof...(Names)>;
+
 /**
  * @brief Base of invalid attribute name.
  */
@@ -18,28 +18,36 @@ struct accessor<std::tm, Context>
     using attribute_name_type = basic_attribute_name<char_type>;
     using format_arg_type = basic_format_arg<Context>;
 
+    static constexpr attribute_table attributes{
+        "year", "month", "mday", "hour", "min", "sec", "wday", "yday", "is_dst"
+    };
+
     static format_arg_type attribute(const std::tm& val, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "year"))
+        switch(attributes.find(attr))
+        {
+        case attributes.index_of("year"):
             return val.tm_year + 1900;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "month"))
+        case attributes.index_of("month"):
             return val.tm_mon;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "mday"))
+        case attributes.index_of("mday"):
             return val.tm_mday;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "hour"))
+        case attributes.index_of("hour"):
             return val.tm_hour;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "min"))
+        case attributes.index_of("min"):
             return val.tm_min;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "sec"))
+        case attributes.index_of("sec"):
             return val.tm_sec;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "wday"))
+        case attributes.index_of("wday"):
             return val.tm_wday;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "yday"))
+        case attributes.index_of("yday"):
             return val.tm_yday;
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "is_dst"))
+        case attributes.index_of("is_dst"):
             return static_cast<bool>(val.tm_isdst);
 
-        throw_invalid_attribute(attr);
+        default:
+            throw_invalid_attribute(attr);
+        }
     }
 };
 
@@ -50,58 +58,60 @@ struct accessor<ChronoType, Context>
     using attribute_name_type = basic_attribute_name<char_type>;
     using format_arg_type = basic_format_arg<Context>;
 
+    static constexpr attribute_table attributes{
+        "ok", "year", "month", "day", "weekday", "hour", "minute", "second"
+    };
+
     static format_arg_type attribute(const ChronoType& val, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "ok"))
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("ok"):
             if constexpr(requires() { {val.ok() } -> std::convertible_to<bool>; })
                 return static_cast<bool>(val.ok());
             else
                 return true;
-        }
 
-        if constexpr(requires() { val.year(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "year"))
+        case attributes.index_of("year"):
+            if constexpr(requires() { val.year(); })
                 return val.year();
-        }
-        if constexpr(requires() { val.month(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "month"))
+            break;
+
+        case attributes.index_of("month"):
+            if constexpr(requires() { val.month(); })
                 return val.month();
-        }
-        if constexpr(requires() { val.day(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "day"))
+            break;
+
+        case attributes.index_of("day"):
+            if constexpr(requires() { val.day(); })
                 return val.day();
-        }
+            break;
 
-        if constexpr(requires() { val.weekday(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "weekday"))
+        case attributes.index_of("weekday"):
+            if constexpr(requires() { val.weekday(); })
                 return val.weekday();
-        }
-        else if constexpr(std::is_constructible_v<std::chrono::weekday, const ChronoType&> &&
-                          !std::same_as<ChronoType, std::chrono::weekday>)
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "weekday"))
+            else if constexpr(std::is_constructible_v<std::chrono::weekday, const ChronoType&> &&
+                              !std::same_as<ChronoType, std::chrono::weekday>)
                 return std::chrono::weekday(val);
-        }
+            break;
 
-        if constexpr(requires() { val.hours(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "hour"))
+        case attributes.index_of("hour"):
+            if constexpr(requires() { val.hours(); })
                 return val.hours();
-        }
-        if constexpr(requires() { val.minutes(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "minute"))
+            break;
+
+        case attributes.index_of("minute"):
+            if constexpr(requires() { val.minutes(); })
                 return val.minutes();
-        }
-        if constexpr(requires() { val.seconds(); })
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "second"))
+            break;
+
+        case attributes.index_of("second"):
+            if constexpr(requires() { val.seconds(); })
                 return val.seconds();
+            break;
+
+        default:
+            break;
         }
 
         throw_invalid_attribute(attr);
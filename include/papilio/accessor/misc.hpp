@@ -16,10 +16,13 @@ struct accessor<std::type_index, Context>
     using attribute_name_type = basic_attribute_name<char_type>;
     using format_arg_type = basic_format_arg<Context>;
 
+    static constexpr attribute_table attributes{"name", "hash_code"};
+
     static format_arg_type attribute(std::type_index info, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "name"))
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("name"):
             if constexpr(char8_like<char_type>)
             {
                 return std::bit_cast<const char_type*>(info.name());
@@ -29,13 +32,12 @@ struct accessor<std::type_index, Context>
                 utf::string_ref narrow_name = info.name();
                 return narrow_name.to_string<char_type>();
             }
-        }
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "hash_code"))
-        {
+        case attributes.index_of("hash_code"):
             return info.hash_code();
-        }
 
-        throw_invalid_attribute(attr);
+        default:
+            throw_invalid_attribute(attr);
+        }
     }
 };
 } // namespace papilio
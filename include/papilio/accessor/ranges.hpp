@@ -46,15 +46,21 @@ struct accessor<utf::basic_string_container<typename Context::char_type>, Contex
         return str.template substr<utf::substr_behavior::empty_string>(s);
     }
 
+    static constexpr attribute_table attributes{"length", "size"};
+
     [[nodiscard]]
     static format_arg_type attribute(const string_container_type& str, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "length"))
+        switch(attributes.find(attr))
+        {
+        case attributes.index_of("length"):
             return str.length();
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "size"))
+        case attributes.index_of("size"):
             return str.size();
-        else
+
+        default:
             throw_invalid_attribute(attr);
+        }
     }
 };
 
@@ -105,10 +111,12 @@ struct contiguous_range_accessor
         return span_t(ptr + s.first, s.length());
     }
 
+    static constexpr attribute_table attributes{"size"};
+
     [[nodiscard]]
     static format_arg_type attribute(const Range& rng, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "size"))
+        if(attributes.find(attr) == attributes.index_of("size"))
             return static_cast<std::size_t>(std::ranges::size(rng));
 
         throw_invalid_attribute(attr);
@@ -161,9 +169,11 @@ struct accessor<std::vector<bool, Allocator>, Context>
         return format_arg_type(std::in_place_type<bool>, vec[static_cast<std::size_t>(i)]);
     }
 
+    static constexpr attribute_table attributes{"size"};
+
     static format_arg_type attribute(const vector_type& vec, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "size"))
+        if(attributes.find(attr) == attributes.index_of("size"))
             return vec.size();
 
         throw_invalid_attribute(attr);
@@ -237,36 +247,36 @@ struct map_accessor
         }
     }
 
+    static constexpr attribute_table attributes{"size", "min", "max"};
+
     [[nodiscard]]
     static format_arg_type attribute(const MapType& m, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "size"))
+        using cmp_t = typename MapType::key_compare;
+        constexpr bool less = detail::cmp_is_less<cmp_t>::value;
+        constexpr bool greater = detail::cmp_is_greater<cmp_t>::value;
+
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("size"):
             return m.size();
-        }
 
-        using cmp_t = typename MapType::key_compare;
-        if constexpr(detail::cmp_is_less<cmp_t>::value)
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "min"))
-            {
+        case attributes.index_of("min"):
+            if constexpr(less)
                 return !m.empty() ? m.begin()->second : format_arg_type();
-            }
-            else if(attr == PAPILIO_TSTRING_VIEW(char_type, "max"))
-            {
+            else if constexpr(greater)
                 return !m.empty() ? std::prev(m.end())->second : format_arg_type();
-            }
-        }
-        else if constexpr(detail::cmp_is_greater<cmp_t>::value)
-        {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "max"))
-            {
-                return !m.empty() ? m.begin()->second : format_arg_type();
-            }
-            else if(attr == PAPILIO_TSTRING_VIEW(char_type, "min"))
-            {
+            break;
+
+        case attributes.index_of("max"):
+            if constexpr(less)
                 return !m.empty() ? std::prev(m.end())->second : format_arg_type();
-            }
+            else if constexpr(greater)
+                return !m.empty() ? m.begin()->second : format_arg_type();
+            break;
+
+        default:
+            break;
         }
 
         throw_invalid_attribute(attr);
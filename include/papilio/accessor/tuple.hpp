@@ -56,19 +56,29 @@ struct tuple_accessor
         }
     }
 
+    static constexpr attribute_table attributes{"size", "first", "second"};
+
     [[nodiscard]]
     static format_arg_type attribute(const Tuple& tp, const attribute_name_type& attr)
     {
-        if constexpr(PairLike)
+        switch(attributes.find(attr))
         {
-            if(attr == PAPILIO_TSTRING_VIEW(char_type, "first"))
+        case attributes.index_of("size"):
+            return std::tuple_size_v<Tuple>;
+
+        case attributes.index_of("first"):
+            if constexpr(PairLike)
                 return get<0>(tp);
-            else if(attr == PAPILIO_TSTRING_VIEW(char_type, "second"))
+            break;
+
+        case attributes.index_of("second"):
+            if constexpr(PairLike)
                 return get<1>(tp);
-        }
+            break;
 
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "size"))
-            return std::tuple_size_v<Tuple>;
+        default:
+            break;
+        }
 
         throw_invalid_attribute(attr);
     }
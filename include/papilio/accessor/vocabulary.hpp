@@ -21,19 +21,23 @@ struct accessor<std::optional<T>, Context>
     using attribute_name_type = basic_attribute_name<char_type>;
     using format_arg_type = basic_format_arg<Context>;
 
+    static constexpr attribute_table attributes{"value", "has_value"};
+
     static format_arg_type attribute(const std::optional<T>& opt, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "value"))
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("value"):
             if(opt.has_value())
                 return *opt;
             else
                 return format_arg_type();
-        }
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "has_value"))
+        case attributes.index_of("has_value"):
             return opt.has_value();
 
-        throw_invalid_attribute(attr);
+        default:
+            throw_invalid_attribute(attr);
+        }
     }
 };
 
@@ -69,12 +73,15 @@ struct accessor<std::variant<Ts...>, Context>
         }(std::make_index_sequence<var_size>());
     }
 
+    static constexpr attribute_table attributes{"index", "value"};
+
     static format_arg_type attribute(const std::variant<Ts...>& var, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "index"))
-            return var.index();
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "value"))
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("index"):
+            return var.index();
+        case attributes.index_of("value"):
             return std::visit(
                 [](auto&& v) -> format_arg_type
                 {
@@ -82,9 +89,10 @@ struct accessor<std::variant<Ts...>, Context>
                 },
                 var
             );
-        }
 
-        throw_invalid_attribute(attr);
+        default:
+            throw_invalid_attribute(attr);
+        }
     }
 
 private:
@@ -110,26 +118,28 @@ struct accessor<std::expected<T, E>, Context>
 
     using expected_type = std::expected<T, E>;
 
+    static constexpr attribute_table attributes{"value", "error", "has_value"};
+
     static format_arg_type attribute(const expected_type& ex, const attribute_name_type& attr)
     {
-        if(attr == PAPILIO_TSTRING_VIEW(char_type, "value"))
+        switch(attributes.find(attr))
         {
+        case attributes.index_of("value"):
             if(ex.has_value())
                 return *ex;
             else
                 return format_arg_type();
-        }
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "error"))
-        {
+        case attributes.index_of("error"):
             if(!ex.has_value())
                 return ex.error();
             else
                 return format_arg_type();
-        }
-        else if(attr == PAPILIO_TSTRING_VIEW(char_type, "has_value"))
+        case attributes.index_of("has_value"):
             return ex.has_value();
 
-        throw_invalid_attribute(attr);
+        default:
+            throw_invalid_attribute(attr);
+        }
     }
 };
 
@@ -0,0 +1,272 @@
+/**
+ * @file compile.hpp
+ * @author HenryAWE
+ * @brief Pre-parsed format strings for formatting the same string many times.
+ */
+
+#ifndef PAPILIO_COMPILE_HPP
+#define PAPILIO_COMPILE_HPP
+
+#pragma once
+
+#include <vector>
+#include "fmtfwd.hpp"
+#include "core.hpp"
+#include "detail/prefix.hpp"
+
+namespace papilio
+{
+/// @addtogroup Format
+/// @{
+
+/**
+ * @brief Pre-parsed format string.
+ *
+ * The format string is parsed only once on construction.
+ * Literal text is stored as spans of the string, argument references are resolved,
+ * and standard format specifications are parsed into @ref std_formatter_data.
+ * Formatting with a compiled format string only needs to run the formatters.
+ *
+ * Fields that need the interpreter (e.g., scripts and chained access) are still supported,
+ * they will be executed by the interpreter when formatting.
+ *
+ * @code{.cpp}
+ * const papilio::compiled_format fmt("{} warning{$ {0} > 1 ? 's'}");
+ * papilio::format(fmt, 1); // Returns "1 warning"
+ * papilio::format(fmt, 2); // Returns "2 warnings"
+ * @endcode
+ *
+ * @tparam CharT Character type
+ *
+ * @warning The format specification of a replacement field cannot contain unbalanced braces.
+ */
+PAPILIO_EXPORT template <typename CharT>
+class basic_compiled_format
+{
+public:
+    using char_type = CharT;
+    using string_type = std::basic_string<CharT>;
+    using string_view_type = std::basic_string_view<CharT>;
+    using string_ref_type = utf::basic_string_ref<CharT>;
+    using size_type = std::size_t;
+
+    /**
+     * @brief Parse the format string.
+     *
+     * @param fmt The format string. It will be copied into the compiled object.
+     *
+     * @throw script_base::error If the braces of the format string are unenclosed.
+     */
+    explicit basic_compiled_format(string_view_type fmt)
+        : m_fmt(fmt)
+    {
+        compile();
+    }
+
+    basic_compiled_format(const basic_compiled_format&) = default;
+    basic_compiled_format(basic_compiled_format&&) noexcept = default;
+
+    basic_compiled_format& operator=(const basic_compiled_format&) = default;
+    basic_compiled_format& operator=(basic_compiled_format&&) noexcept = default;
+
+    /**
+     * @brief Get the source format string.
+     */
+    [[nodiscard]]
+    string_view_type get() const noexcept
+    {
+        return m_fmt;
+    }
+
+    /**
+     * @brief Format with the arguments of the format context.
+     *
+     * @param fmt_ctx Format context
+     */
+    template <typename Context>
+    void format(Context& fmt_ctx) const
+    {
+        using context_t = format_context_traits<Context>;
+        using parse_context = basic_format_parse_context<Context>;
+
+        static_assert(std::same_as<typename Context::char_type, CharT>);
+
+        parse_context parse_ctx(string_ref_type(m_fmt), context_t::get_args(fmt_ctx));
+        detail::fmt_segment_executor<Context> executor(m_fmt, parse_ctx, fmt_ctx);
+
+        for(const segment& seg : m_segments)
+        {
+            if(!executor.exec(seg, seg.has_data ? &seg.data : nullptr))
+                break;
+        }
+    }
+
+private:
+    struct segment : public detail::fmt_segment
+    {
+        // Pre-parsed standard format specification
+        std_formatter_data data;
+        bool has_data = false;
+    };
+
+    string_type m_fmt;
+    std::vector<segment> m_segments;
+
+    void compile()
+    {
+        detail::parse_fmt_segments<CharT>(
+            m_fmt,
+            [this](const detail::fmt_segment& seg)
+            {
+                segment& result = m_segments.emplace_back();
+                static_cast<detail::fmt_segment&>(result) = seg;
+
+                if(seg.kind == detail::fmt_segment_kind::literal ||
+                   seg.kind == detail::fmt_segment_kind::interpreted ||
+                   seg.dynamic_spec)
+                    return;
+
+                result.has_data = preparse_spec(
+                    string_view_type(m_fmt).substr(seg.offset, seg.size),
+                    result.data
+                );
+            }
+        );
+    }
+
+    // Parses the specification with the union of accepted types of built-in formatters.
+    // The actual type will be checked when formatting.
+    static bool preparse_spec(string_view_type spec, std_formatter_data& out)
+    {
+        using context_type = basic_format_context<format_iterator_for<CharT>, CharT>;
+        using parse_context = basic_format_parse_context<context_type>;
+
+        parse_context parse_ctx(string_ref_type(spec), empty_format_args_for<context_type>());
+        std_formatter_parser<parse_context, true> parser;
+
+        try
+        {
+            auto [result, it] = parser.parse(parse_ctx, U"XxBbodcfFgGeEaAs?pP");
+            if(it != parse_ctx.end())
+                return false;
+
+            out = result;
+            return true;
+        }
+        catch(const format_error&)
+        {
+            // Leave it to the formatter of the actual argument
+            return false;
+        }
+    }
+};
+
+PAPILIO_EXPORT using compiled_format = basic_compiled_format<char>;
+PAPILIO_EXPORT using wcompiled_format = basic_compiled_format<wchar_t>;
+
+namespace detail
+{
+    template <typename CharT, typename OutputIt, typename Context>
+    OutputIt vformat_compiled_to_impl(
+        OutputIt out,
+        locale_ref loc,
+        const basic_compiled_format<CharT>& fmt,
+        const basic_format_args_ref<Context>& args
+    )
+    {
+        static_assert(std::same_as<OutputIt, typename Context::iterator>);
+
+        Context fmt_ctx(loc, out, args);
+        fmt.format(fmt_ctx);
+
+        return fmt_ctx.out();
+    }
+} // namespace detail
+
+PAPILIO_EXPORT template <typename OutputIt, typename CharT>
+OutputIt vformat_to(
+    OutputIt out,
+    const basic_compiled_format<CharT>& fmt,
+    const std::type_identity_t<format_args_ref_for<OutputIt, CharT>>& args
+)
+{
+    using context_type = basic_format_context<OutputIt, CharT>;
+
+    return detail::vformat_compiled_to_impl<CharT, OutputIt, context_type>(
+        std::move(out), nullptr, fmt, args
+    );
+}
+
+PAPILIO_EXPORT template <typename OutputIt, typename CharT>
+OutputIt vformat_to(
+    OutputIt out,
+    const std::locale& loc,
+    const basic_compiled_format<CharT>& fmt,
+    const std::type_identity_t<format_args_ref_for<OutputIt, CharT>>& args
+)
+{
+    using context_type = basic_format_context<OutputIt, CharT>;
+
+    return detail::vformat_compiled_to_impl<CharT, OutputIt, context_type>(
+        std::move(out), loc, fmt, args
+    );
+}
+
+PAPILIO_EXPORT template <typename OutputIt, typename CharT, typename... Args>
+OutputIt format_to(OutputIt out, const basic_compiled_format<CharT>& fmt, Args&&... args)
+{
+    using context_type = basic_format_context<OutputIt, CharT>;
+    return PAPILIO_NS vformat_to(
+        std::move(out),
+        fmt,
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+PAPILIO_EXPORT template <typename OutputIt, typename CharT, typename... Args>
+OutputIt format_to(
+    OutputIt out,
+    const std::locale& loc,
+    const basic_compiled_format<CharT>& fmt,
+    Args&&... args
+)
+{
+    using context_type = basic_format_context<OutputIt, CharT>;
+    return PAPILIO_NS vformat_to(
+        std::move(out),
+        loc,
+        fmt,
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+PAPILIO_EXPORT template <typename CharT, typename... Args>
+[[nodiscard]]
+std::basic_string<CharT> format(const basic_compiled_format<CharT>& fmt, Args&&... args)
+{
+    std::basic_string<CharT> result;
+    PAPILIO_NS format_to(std::back_inserter(result), fmt, std::forward<Args>(args)...);
+
+    return result;
+}
+
+PAPILIO_EXPORT template <typename CharT, typename... Args>
+[[nodiscard]]
+std::basic_string<CharT> format(
+    const std::locale& loc,
+    const basic_compiled_format<CharT>& fmt,
+    Args&&... args
+)
+{
+    std::basic_string<CharT> result;
+    PAPILIO_NS format_to(std::back_inserter(result), loc, fmt, std::forward<Args>(args)...);
+
+    return result;
+}
+
+/// @}
+} // namespace papilio
+
+#include "detail/suffix.hpp"
+
+#endif
@@ -14,6 +14,16 @@
 #include <variant>
 #include <typeinfo>
 #include <map>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <span>
 #include <array>
 #include <charconv>
@@ -29,21 +39,6 @@
 
 namespace papilio
 {
-/**
- * @brief Base of all format error.
- *
- * @ingroup Format
- */
-PAPILIO_EXPORT class format_error : public std::runtime_error
-{
-public:
-    using runtime_error::runtime_error;
-
-    format_error(const format_error&) = default;
-
-    ~format_error() override;
-};
-
 /**
  * @brief Format alignment.
  * Filling character will be used for the remaining space.
@@ -144,14 +139,229 @@ constexpr inline range_format format_kind<R> = []
 
 /// @}
 
+/// @addtogroup Parse
+/// @{
+
+namespace detail
+{
+    /**
+     * @brief Kind of a segment in a pre-parsed format string.
+     *
+     * @sa fmt_segment
+     */
+    enum class fmt_segment_kind : std::uint8_t
+    {
+        /** Ordinary text, including the unescaped brace of `{{` and `}}`. */
+        literal = 0,
+        /** Replacement field using the default argument index, e.g. `{}` or `{:spec}`. */
+        automatic = 1,
+        /** Replacement field with an explicit argument index, e.g. `{0}` or `{0:spec}`. */
+        indexed = 2,
+        /** Replacement field referring to a named argument, e.g. `{name}` or `{name:spec}`. */
+        named = 3,
+        /**
+         * Field that can only be executed by the interpreter,
+         * e.g. scripts or replacement fields with chained access.
+         */
+        interpreted = 4
+    };
+
+    /**
+     * @brief A segment of a pre-parsed format string.
+     *
+     * All positions are offsets in code units from the beginning of the format string.
+     *
+     * - Literal: `[offset, offset + size)` is the text to be copied.
+     * - Replacement field: `[offset, offset + size)` is the format specification,
+     *   the closing brace of the field is at `offset + size`.
+     * - Interpreted: `[offset, offset + size)` is the whole field, including both braces.
+     *
+     * @sa fmt_segment_kind
+     */
+    struct fmt_segment
+    {
+        using size_type = std::size_t;
+
+        fmt_segment_kind kind = fmt_segment_kind::literal;
+        /** The format specification contains nested replacement fields. */
+        bool dynamic_spec = false;
+        size_type offset = 0;
+        size_type size = 0;
+        /** Index of an indexed field, or offset of the name of a named field. */
+        size_type arg_id = 0;
+        /** Length of the name of a named field. */
+        size_type name_size = 0;
+        /**
+         * Position of the argument of a named field among the named arguments,
+         * or `no_slot` if it is unknown.
+         */
+        size_type named_slot = no_slot;
+
+        static constexpr size_type no_slot = static_cast<size_type>(-1);
+    };
+
+    /**
+     * @brief Compact segment of a format string checked at compile time.
+     *
+     * The positions have the same meaning as @ref fmt_segment.
+     * If `has_data` is true, the standard format specification of the field
+     * has been parsed and stored in the remaining members.
+     *
+     * @note The members are kept small because the table is passed with every format string.
+     */
+    struct fmt_static_segment
+    {
+        std::uint8_t offset = 0;
+        std::uint8_t size = 0;
+        std::uint8_t arg_id = 0;
+        std::uint8_t name_size = 0;
+        /** Same as @ref fmt_segment::named_slot. The max value means unknown. */
+        std::uint8_t named_slot = std::numeric_limits<std::uint8_t>::max();
+        std::uint8_t width = 0;
+        std::uint8_t precision = 0;
+        char type = '\0';
+        fmt_segment_kind kind = fmt_segment_kind::literal;
+        format_align align = format_align::default_align;
+        format_sign sign = format_sign::default_sign;
+        /** Code units of the filling character at the beginning of the specification. */
+        std::uint8_t fill_size : 3 = 0;
+        bool dynamic_spec : 1 = false;
+        bool has_data : 1 = false;
+        bool fill_zero : 1 = false;
+        bool alternate_form : 1 = false;
+        bool use_locale : 1 = false;
+    };
+
+    /**
+     * @brief View of the segments of a format string checked at compile time.
+     *
+     * An empty table means the format string needs to be parsed at runtime,
+     * e.g., the string is too long or it has too many segments.
+     */
+    class fmt_segment_table
+    {
+    public:
+        using value_type = fmt_static_segment;
+        using size_type = std::size_t;
+        using const_iterator = const value_type*;
+
+        /** Max length of format strings that can be stored in the table. */
+        static constexpr size_type max_fmt_size = std::numeric_limits<std::uint8_t>::max();
+
+        constexpr fmt_segment_table() noexcept = default;
+
+        constexpr fmt_segment_table(const value_type* data, size_type size) noexcept
+            : m_data(data), m_size(size) {}
+
+        [[nodiscard]]
+        constexpr bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        [[nodiscard]]
+        constexpr size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        [[nodiscard]]
+        constexpr const_iterator begin() const noexcept
+        {
+            return m_data;
+        }
+
+        [[nodiscard]]
+        constexpr const_iterator end() const noexcept
+        {
+            return m_data + m_size;
+        }
+
+    private:
+        const value_type* m_data = nullptr;
+        size_type m_size = 0;
+    };
+
+    /**
+     * @brief Storage of the segments of a format string checked at compile time.
+     *
+     * @tparam N Max number of segments
+     */
+    template <std::size_t N>
+    class fmt_segment_buffer
+    {
+    public:
+        using value_type = fmt_static_segment;
+        using size_type = std::size_t;
+
+        static_assert(N <= std::numeric_limits<std::uint8_t>::max());
+
+        static constexpr size_type max_size = N;
+
+        constexpr fmt_segment_buffer() noexcept = default;
+
+        [[nodiscard]]
+        constexpr size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        constexpr void push_back(const value_type& seg) noexcept
+        {
+            PAPILIO_ASSERT(m_size < max_size);
+            m_segments[m_size++] = seg;
+        }
+
+        constexpr void clear() noexcept
+        {
+            m_size = 0;
+        }
+
+        [[nodiscard]]
+        constexpr fmt_segment_table view() const noexcept
+        {
+            return fmt_segment_table(m_segments.data(), m_size);
+        }
+
+    private:
+        std::array<value_type, N> m_segments{};
+        std::uint8_t m_size = 0;
+    };
+
+    /**
+     * @brief Max number of segments stored for a format string of the arguments.
+     *
+     * It is enough for a string whose replacement fields are separated by literal text, e.g., "a={} b={}",
+     * so the storage grows with the arguments instead of being large for every call.
+     */
+    template <typename... Args>
+    inline constexpr std::size_t fmt_segment_capacity_v = (std::min)(
+        2 * sizeof...(Args) + 1,
+        std::size_t(std::numeric_limits<std::uint8_t>::max())
+    );
+
+    template <typename CharT, typename Callback>
+    constexpr void parse_fmt_segments(std::basic_string_view<CharT> fmt, Callback&& cb);
+
+    template <typename CharT, typename... Args>
+    consteval fmt_segment_buffer<fmt_segment_capacity_v<Args...>> compile_fmt_string(std::basic_string_view<CharT> fmt);
+} // namespace detail
+
+/// @}
+
 /**
  * @brief Format string.
  * Provides compile-time check if possible.
  *
- * @tparam CharT Character type
+ * A format string constructed from a string literal is parsed at compile time.
+ * Malformed format strings, invalid argument indices, and standard format specifications
+ * that are not accepted by the type of argument will be reported as compile errors.
+ * The parsed segments are stored in the object, so the formatting functions can skip parsing at runtime.
+ * The storage holds up to `2 * sizeof...(Args) + 1` segments. Strings with more segments are parsed at runtime.
  *
- * @note Currently, this class does not provide any compile-time checking.
- *       It is provided only for consistency with the STL.
+ * Other strings (e.g., `std::string_view` or a mutable `char` buffer) are parsed by the interpreter at runtime.
+ *
+ * @tparam CharT Character type
  *
  * @ingroup Format
  */
@@ -163,6 +373,21 @@ public:
     using string_view_type = std::basic_string_view<CharT>;
     using args_type = std::tuple<Args...>;
 
+    template <std::size_t N>
+    consteval basic_format_string(const CharT (&fmt)[N])
+        : m_fmt(fmt), m_segments(detail::compile_fmt_string<CharT, Args...>(m_fmt))
+    {}
+
+    /**
+     * @brief Format string stored in a mutable buffer, which is parsed at runtime.
+     *
+     * @note The string ends at the first null character.
+     */
+    template <std::size_t N>
+    constexpr basic_format_string(CharT (&fmt)[N]) noexcept
+        : m_fmt(fmt)
+    {}
+
     template <std::convertible_to<string_view_type> T>
     constexpr basic_format_string(const T& fmt) noexcept(std::is_nothrow_convertible_v<string_view_type, T>)
         : m_fmt(fmt)
@@ -183,8 +408,20 @@ public:
         return m_fmt;
     }
 
+    /**
+     * @brief Get the segments parsed at compile time.
+     *
+     * @return An empty table if the format string needs to be parsed at runtime.
+     */
+    [[nodiscard]]
+    constexpr detail::fmt_segment_table segments() const noexcept
+    {
+        return m_segments.view();
+    }
+
 private:
     string_view_type m_fmt;
+    detail::fmt_segment_buffer<detail::fmt_segment_capacity_v<Args...>> m_segments;
 };
 
 /**
@@ -1212,7 +1449,16 @@ public:
 
     private:
         static constexpr std::size_t storage_size = 32;
-        mutable static_storage<storage_size> m_storage;
+        static constexpr std::size_t storage_align = alignof(void*);
+        mutable static_storage<storage_size, storage_align> m_storage;
+
+        template <typename T>
+        using impl_for = std::conditional_t<
+            detail::use_soo_handle<T> &&
+                sizeof(handle_impl_soo<T>) <= storage_size &&
+                alignof(handle_impl_soo<T>) <= storage_align,
+            handle_impl_soo<T>,
+            handle_impl_ptr<T>>;
 
         handle_impl_base* ptr() const noexcept
         {
@@ -1224,6 +1470,7 @@ public:
         {
             static_assert(use_handle_v<typename Impl::value_type>);
             static_assert(sizeof(Impl) <= storage_size);
+            static_assert(alignof(Impl) <= storage_align);
 
             new(ptr()) Impl(std::forward<Args>(args)...);
         }
@@ -1231,25 +1478,13 @@ public:
         template <typename T>
         void construct(T&& val) noexcept
         {
-            using type = std::remove_cvref_t<T>;
-            using impl_t = std::conditional_t<
-                detail::use_soo_handle<type> && sizeof(handle_impl_soo<type>) <= storage_size,
-                handle_impl_soo<type>,
-                handle_impl_ptr<type>>;
-
-            construct_impl<impl_t>(std::forward<T>(val));
+            construct_impl<impl_for<std::remove_cvref_t<T>>>(std::forward<T>(val));
         }
 
         template <typename T>
         void construct(independent_t, T&& val)
         {
-            using type = std::remove_cvref_t<T>;
-            using impl_t = std::conditional_t<
-                detail::use_soo_handle<type> && sizeof(handle_impl_soo<type>) <= storage_size,
-                handle_impl_soo<type>,
-                handle_impl_ptr<type>>;
-
-            construct_impl<impl_t>(independent, std::forward<T>(val));
+            construct_impl<impl_for<std::remove_cvref_t<T>>>(independent, std::forward<T>(val));
         }
 
         // Copy this handle to another uninitialized handle
@@ -1292,10 +1527,51 @@ public:
         const void*,
         handle>;
 
+    /**
+     * @brief Type tag of the stored value.
+     *
+     * The values are the same as the indices of the alternatives in variant_type.
+     */
+    enum class type_tag : std::uint8_t
+    {
+        none = 0,
+        bool_type,
+        codepoint_type,
+        int_type,
+        uint_type,
+        long_long_type,
+        ulong_long_type,
+        float_type,
+        double_type,
+        long_double_type,
+        string_type,
+        pointer_type,
+        handle_type
+    };
+
+private:
+    template <typename T, std::size_t I = 0>
+    static consteval type_tag tag_of_impl() noexcept
+    {
+        static_assert(I < std::variant_size_v<variant_type>, "Invalid type");
+
+        if constexpr(std::same_as<T, std::variant_alternative_t<I, variant_type>>)
+            return static_cast<type_tag>(I);
+        else
+            return tag_of_impl<T, I + 1>();
+    }
+
+public:
+    template <typename T>
+    static constexpr type_tag tag_of = tag_of_impl<T>();
+
     basic_format_arg() noexcept
-        : m_val() {}
+        : m_tag(type_tag::none) {}
 
-    basic_format_arg(const basic_format_arg&) noexcept = default;
+    basic_format_arg(const basic_format_arg& other) noexcept
+    {
+        copy_from(other);
+    }
 
     // Avoid accidentally mixing format arguments from different context
     template <typename AnotherContext>
@@ -1303,100 +1579,136 @@ public:
     basic_format_arg(const basic_format_arg<AnotherContext>&) = delete;
 
     basic_format_arg(basic_format_arg&& other) noexcept
-        : m_val(std::move(other.m_val))
     {
-        other.m_val.template emplace<std::monostate>();
+        move_from(std::move(other));
     }
 
     basic_format_arg(bool val) noexcept
-        : m_val(std::in_place_type<bool>, val) {}
+    {
+        construct<bool>(val);
+    }
 
     basic_format_arg(utf::codepoint cp) noexcept
-        : m_val(std::in_place_type<utf::codepoint>, cp) {}
+    {
+        construct<utf::codepoint>(cp);
+    }
 
     template <char_like Char>
     basic_format_arg(Char ch) noexcept
-        : m_val(std::in_place_type<utf::codepoint>, static_cast<char32_t>(ch))
-    {}
+    {
+        construct<utf::codepoint>(static_cast<char32_t>(ch));
+    }
 
     template <detail::acceptable_integral Integral>
     basic_format_arg(Integral val) noexcept
-        : m_val(std::in_place_type<detail::convert_int_t<Integral>>, val)
-    {}
+    {
+        construct<detail::convert_int_t<Integral>>(val);
+    }
 
     template <detail::acceptable_fp Float>
     basic_format_arg(Float val) noexcept
-        : m_val(val)
-    {}
+    {
+        construct<Float>(val);
+    }
 
     basic_format_arg(string_container_type str) noexcept
-        : m_val(std::in_place_type<string_container_type>, std::move(str)) {}
+    {
+        construct<string_container_type>(std::move(str));
+    }
 
     template <basic_string_like<char_type> String>
     basic_format_arg(String&& str)
-        : m_val(std::in_place_type<string_container_type>, std::forward<String>(str))
-    {}
+    {
+        construct<string_container_type>(std::forward<String>(str));
+    }
 
     template <basic_string_like<char_type> String>
     basic_format_arg(independent_t, String&& str)
-        : m_val(std::in_place_type<string_container_type>, independent, std::forward<String>(str))
-    {}
+    {
+        construct<string_container_type>(independent, std::forward<String>(str));
+    }
 
     template <typename T, typename... Args>
     basic_format_arg(std::in_place_type_t<T>, Args&&... args)
-        : m_val(std::in_place_type<T>, std::forward<Args>(args)...)
-    {}
+    {
+        construct<T>(std::forward<Args>(args)...);
+    }
 
     template <typename T>
     requires(std::is_pointer_v<T> && !char_like<std::remove_pointer_t<T>>)
     basic_format_arg(T ptr) noexcept
-        : m_val(std::in_place_type<const void*>, ptr)
-    {}
+    {
+        construct<const void*>(ptr);
+    }
 
     basic_format_arg(std::nullptr_t) noexcept
-        : m_val(std::in_place_type<const void*>, nullptr) {}
+    {
+        construct<const void*>(nullptr);
+    }
 
     template <typename T>
     requires(use_handle_v<T>)
     basic_format_arg(const T& val) noexcept
-        : m_val(std::in_place_type<handle>, val)
-    {}
+    {
+        construct<handle>(val);
+    }
 
     template <typename T, std::size_t N>
     requires(!char_like<T>)
     basic_format_arg(T (&arr)[N]) noexcept
-        : m_val(std::in_place_type<handle>, std::span<std::add_const_t<T>>(arr, N))
-    {}
+    {
+        construct<handle>(std::span<std::add_const_t<T>>(arr, N));
+    }
 
     template <typename T, std::size_t N>
     requires(!char_like<T>)
     basic_format_arg(const std::array<T, N>& arr) noexcept
-        : m_val(std::in_place_type<handle>, std::span<const T>(arr.data(), N))
-    {}
+    {
+        construct<handle>(std::span<const T>(arr.data(), N));
+    }
 
     template <typename T>
     requires(use_handle_v<T>)
     basic_format_arg(independent_t, T&& val) noexcept
-        : m_val(std::in_place_type<handle>, independent, std::forward<T>(val))
-    {}
+    {
+        construct<handle>(independent, std::forward<T>(val));
+    }
 
     basic_format_arg(const std::type_info& info) noexcept
-        : m_val(std::in_place_type<handle>, std::type_index(info)) {}
+    {
+        construct<handle>(std::type_index(info));
+    }
+
+    ~basic_format_arg()
+    {
+        destroy();
+    }
+
+    basic_format_arg& operator=(const basic_format_arg& rhs) noexcept
+    {
+        if(this == &rhs)
+            return *this;
+        destroy();
+        copy_from(rhs);
 
-    basic_format_arg& operator=(const basic_format_arg&) = default;
+        return *this;
+    }
 
     basic_format_arg& operator=(basic_format_arg&& rhs) noexcept
     {
-        basic_format_arg(std::move(rhs)).swap(*this);
+        if(this == &rhs)
+            return *this;
+        destroy();
+        move_from(std::move(rhs));
 
         return *this;
     }
 
     void swap(basic_format_arg& other) noexcept
     {
-        using std::swap;
-
-        swap(m_val, other.m_val);
+        basic_format_arg tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
     }
 
     friend void swap(basic_format_arg& lhs, basic_format_arg& rhs) noexcept
@@ -1404,28 +1716,80 @@ public:
         lhs.swap(rhs);
     }
 
-    template <typename Visitor>
-    decltype(auto) visit(Visitor&& vis) const // GCC needs this function to be defined in the front of the class
+    /**
+     * @brief Get the type tag of the stored value.
+     */
+    [[nodiscard]]
+    type_tag tag() const noexcept
     {
-        return std::visit(std::forward<Visitor>(vis), m_val);
+        return m_tag;
     }
 
-    [[nodiscard]]
-    variant_type& to_variant() & noexcept
+    template <typename Visitor>
+    decltype(auto) visit(Visitor&& vis) const // GCC needs this function to be defined in the front of the class
     {
-        return m_val;
+        switch(m_tag)
+        {
+        case type_tag::none:
+            return std::invoke(std::forward<Visitor>(vis), ref<std::monostate>());
+        case type_tag::bool_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<bool>());
+        case type_tag::codepoint_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<utf::codepoint>());
+        case type_tag::int_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<int>());
+        case type_tag::uint_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<unsigned int>());
+        case type_tag::long_long_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<long long int>());
+        case type_tag::ulong_long_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<unsigned long long int>());
+        case type_tag::float_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<float>());
+        case type_tag::double_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<double>());
+        case type_tag::long_double_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<long double>());
+        case type_tag::string_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<string_container_type>());
+        case type_tag::pointer_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<const void*>());
+        case type_tag::handle_type:
+            return std::invoke(std::forward<Visitor>(vis), ref<handle>());
+
+        default:
+            PAPILIO_UNREACHABLE();
+        }
     }
 
+    /**
+     * @brief Copy the stored value into a variant.
+     *
+     * @note The variant is returned by value, because the argument does not store its value in a variant.
+     */
     [[nodiscard]]
-    variant_type&& to_variant() && noexcept
+    variant_type to_variant() const&
     {
-        return std::move(m_val);
+        return visit(
+            []<typename T>(const T& v) -> variant_type
+            {
+                return variant_type(std::in_place_type<T>, v);
+            }
+        );
     }
 
+    /**
+     * @brief Move the stored value into a variant. The argument will be empty.
+     */
     [[nodiscard]]
-    const variant_type& to_variant() const& noexcept
+    variant_type to_variant() &&
     {
-        return m_val;
+        variant_type result = m_tag == type_tag::string_type ?
+                                  variant_type(std::in_place_type<string_container_type>, std::move(mut_ref<string_container_type>())) :
+                                  std::as_const(*this).to_variant();
+        destroy();
+
+        return result;
     }
 
     [[nodiscard]]
@@ -1470,25 +1834,22 @@ public:
     [[nodiscard]]
     bool holds() const noexcept
     {
-        return std::holds_alternative<T>(m_val);
+        return m_tag == tag_of<T>;
     }
 
     [[nodiscard]]
     bool has_ownership() const noexcept
     {
-        return visit(
-            []<typename T>(const T& v) -> bool
-            {
-                if constexpr(requires() { v.has_ownership(); })
-                {
-                    return v.has_ownership();
-                }
-                else
-                {
-                    return true;
-                }
-            }
-        );
+        switch(m_tag)
+        {
+        case type_tag::string_type:
+            return ref<string_container_type>().has_ownership();
+        case type_tag::handle_type:
+            return ref<handle>().has_ownership();
+
+        default:
+            return true;
+        }
     }
 
     [[nodiscard]]
@@ -1497,7 +1858,7 @@ public:
     [[nodiscard]]
     bool empty() const noexcept
     {
-        return holds<std::monostate>();
+        return m_tag == type_tag::none;
     }
 
     explicit operator bool() const noexcept
@@ -1505,23 +1866,26 @@ public:
         return !empty();
     }
 
+    /**
+     * @brief Get the stored value.
+     */
     template <typename T>
     [[nodiscard]]
-    friend const auto& get(const basic_format_arg& val)
+    friend decltype(auto) get(const basic_format_arg& val)
     {
         if constexpr(char_like<T> || std::same_as<std::remove_cvref_t<T>, utf::codepoint>)
-            return std::get<utf::codepoint>(val.m_val);
+            return val.template checked_ref<utf::codepoint>();
         else if constexpr(std::integral<T>)
-            return std::get<detail::convert_int_t<T>>(val.m_val);
+            return val.template checked_ref<detail::convert_int_t<T>>();
         else if constexpr(detail::acceptable_fp<T>)
-            return std::get<T>(val.m_val);
+            return val.template checked_ref<T>();
         else if constexpr(basic_string_like<T, char_type>)
-            return std::get<string_container_type>(val.m_val);
+            return val.template checked_ref<string_container_type>();
         else if constexpr(std::is_pointer_v<T>)
-            return std::get<const void*>(val.m_val);
+            return val.template checked_ref<const void*>();
         else if constexpr(detail::use_handle<T, char_type>)
         {
-            const handle& h = std::get<handle>(val.m_val);
+            const handle& h = val.template checked_ref<handle>();
             return handle_cast<T>(h);
         }
         else
@@ -1535,27 +1899,130 @@ public:
     void skip_spec(parse_context& parse_ctx);
 
 private:
-    variant_type m_val;
-};
+    static constexpr std::size_t storage_align = (std::max)(alignof(void*), alignof(long double));
+    static constexpr std::size_t storage_size = std::max({
+        sizeof(long long int),
+        sizeof(long double),
+        sizeof(string_container_type),
+        sizeof(handle)
+    });
+
+    static_assert(alignof(string_container_type) <= storage_align);
+    static_assert(alignof(handle) <= storage_align);
+
+    // A raw array instead of static_storage, so the tag can be placed before the padding of the aligned storage.
+    alignas(storage_align) std::byte m_storage[storage_size];
+    type_tag m_tag;
 
-namespace detail
-{
     template <typename T>
-    consteval std::size_t count_if_named_arg() noexcept
+    const T& ref() const noexcept
     {
-        if constexpr(is_named_arg_v<std::remove_cvref_t<T>>)
-            return 1;
-        else
-            return 0;
+        PAPILIO_ASSERT(holds<T>());
+
+        return *std::launder(reinterpret_cast<const T*>(m_storage));
     }
 
-    template <typename... Ts>
-    consteval std::size_t get_named_arg_count() noexcept
+    template <typename T>
+    T& mut_ref() noexcept
     {
-        using tuple_t = std::tuple<Ts...>;
-        using std::tuple_element_t;
+        PAPILIO_ASSERT(holds<T>());
 
-        return []<std::size_t... Is>(std::index_sequence<Is...>) -> std::size_t
+        return *std::launder(reinterpret_cast<T*>(m_storage));
+    }
+
+    template <typename T>
+    const T& checked_ref() const
+    {
+        if(!holds<T>())
+            throw std::bad_variant_access();
+        return ref<T>();
+    }
+
+    // Construct a value in the uninitialized storage.
+    template <typename T, typename... Args>
+    void construct(Args&&... args)
+    {
+        static_assert(alignof(T) <= storage_align);
+        std::construct_at(reinterpret_cast<T*>(m_storage), std::forward<Args>(args)...);
+        m_tag = tag_of<T>;
+    }
+
+    void copy_from(const basic_format_arg& other) noexcept
+    {
+        switch(other.m_tag)
+        {
+        case type_tag::string_type:
+            construct<string_container_type>(other.ref<string_container_type>());
+            break;
+        case type_tag::handle_type:
+            construct<handle>(other.ref<handle>());
+            break;
+
+        default: // Other types are trivially copyable
+            std::memcpy(m_storage, other.m_storage, storage_size);
+            m_tag = other.m_tag;
+            break;
+        }
+    }
+
+    // The moved-from argument will be empty.
+    void move_from(basic_format_arg&& other) noexcept
+    {
+        switch(other.m_tag)
+        {
+        case type_tag::string_type:
+            construct<string_container_type>(std::move(other.mut_ref<string_container_type>()));
+            break;
+        case type_tag::handle_type:
+            construct<handle>(std::move(other.mut_ref<handle>()));
+            break;
+
+        default:
+            std::memcpy(m_storage, other.m_storage, storage_size);
+            m_tag = other.m_tag;
+            break;
+        }
+
+        other.destroy();
+    }
+
+    void destroy() noexcept
+    {
+        switch(m_tag)
+        {
+        case type_tag::string_type:
+            std::destroy_at(&mut_ref<string_container_type>());
+            break;
+        case type_tag::handle_type:
+            std::destroy_at(&mut_ref<handle>());
+            break;
+
+        default:
+            break;
+        }
+
+        m_tag = type_tag::none;
+    }
+};
+
+namespace detail
+{
+    template <typename T>
+    consteval std::size_t count_if_named_arg() noexcept
+    {
+        if constexpr(is_named_arg_v<std::remove_cvref_t<T>>)
+            return 1;
+        else
+            return 0;
+    }
+
+    template <typename... Ts>
+    consteval std::size_t get_named_arg_count() noexcept
+    {
+        using tuple_t = std::tuple<Ts...>;
+        using std::tuple_element_t;
+
+        return []<std::size_t... Is>(std::index_sequence<Is...>) -> std::size_t
         {
             return (0 + ... + count_if_named_arg<tuple_element_t<Is, tuple_t>>());
         }(std::make_index_sequence<sizeof...(Ts)>());
@@ -1680,6 +2147,20 @@ public:
     virtual size_type indexed_size() const noexcept = 0;
     virtual size_type named_size() const noexcept = 0;
 
+    /**
+     * @brief Get a named argument by its position among the named arguments passed to the constructor.
+     *
+     * It is used by the replacement fields resolved at compile time. @sa static_named_arg
+     *
+     * @return Pointer to the argument, or nullptr if the positions of named arguments are not preserved.
+     */
+    [[nodiscard]]
+    virtual const format_arg_type* get_named_at(size_type slot) const noexcept
+    {
+        (void)slot;
+        return nullptr;
+    }
+
     const format_arg_type& operator[](const indexing_value_type& idx) const
     {
         return get(idx);
@@ -1775,11 +2256,12 @@ public:
     using vector_type = fixed_vector<
         format_arg_type,
         IndexedArgumentCount>;
-    using map_type = fixed_flat_map<
+    using name_vector_type = fixed_vector<
         string_view_type,
+        NamedArgumentCount>;
+    using named_vector_type = fixed_vector<
         format_arg_type,
-        NamedArgumentCount,
-        std::less<>>;
+        NamedArgumentCount>;
 
     template <typename... Args>
     static_format_args(Args&&... args)
@@ -1798,10 +2280,10 @@ public:
     [[nodiscard]]
     const format_arg_type& get(string_view_type k) const override
     {
-        auto it = m_named_args.find(k);
-        if(it == m_named_args.end())
+        const size_type slot = find_named(k);
+        if(slot == npos)
             this->throw_invalid_named_argument();
-        return it->second;
+        return m_named_args[slot];
     }
 
     using my_base::get;
@@ -1809,7 +2291,7 @@ public:
     [[nodiscard]]
     bool contains(string_view_type key) const noexcept override
     {
-        return m_named_args.contains(key);
+        return find_named(key) != npos;
     }
 
     using my_base::contains;
@@ -1828,7 +2310,17 @@ public:
         return NamedArgumentCount;
     }
 
+    [[nodiscard]]
+    const format_arg_type* get_named_at(size_type slot) const noexcept override
+    {
+        if(slot >= m_named_args.size())
+            return nullptr;
+        return &m_named_args[slot];
+    }
+
 private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
     template <typename... Args>
     void construct(Args&&... args) noexcept
     {
@@ -1845,7 +2337,21 @@ private:
     }
 
     vector_type m_indexed_args;
-    map_type m_named_args;
+    // Named arguments are kept in order, so the slots resolved at compile time can be used directly.
+    name_vector_type m_names;
+    named_vector_type m_named_args;
+
+    // The last one wins if a name is used more than once
+    size_type find_named(string_view_type k) const noexcept
+    {
+        for(size_type i = m_names.size(); i > 0; --i)
+        {
+            if(m_names[i - 1] == k)
+                return i - 1;
+        }
+
+        return npos;
+    }
 
     template <typename T>
     requires(!is_named_arg_v<T>)
@@ -1858,10 +2364,8 @@ private:
     requires(is_named_arg_v<T> && std::same_as<char_type, typename T::char_type>)
     void emplace(T&& na) noexcept(std::is_nothrow_constructible_v<format_arg_type, typename T::value_type>)
     {
-        m_named_args.insert_or_assign(
-            na.name,
-            PAPILIO_NS forward_like<T>(na.value)
-        );
+        m_names.emplace_back(na.name);
+        m_named_args.emplace_back(PAPILIO_NS forward_like<T>(na.value));
     }
 };
 
@@ -1882,10 +2386,6 @@ public:
     using vector_type = small_vector<
         format_arg_type,
         6>;
-    using map_type = std::map<
-        string_type,
-        format_arg_type,
-        std::less<>>;
 
     basic_dynamic_format_args() = default;
     basic_dynamic_format_args(const basic_dynamic_format_args&) = delete;
@@ -1897,6 +2397,11 @@ public:
         append(std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Add an argument.
+     *
+     * @note If a named argument with the same name already exists, the new one will be ignored.
+     */
     template <typename T>
     void emplace(T&& val)
     {
@@ -1907,10 +2412,18 @@ public:
                 "Invalid char type"
             );
 
-            m_named_args.emplace(std::make_pair(
-                PAPILIO_NS forward_like<T>(val.name),
-                PAPILIO_NS forward_like<T>(val.value)
-            ));
+            const string_view_type name = val.name;
+            const std::size_t h = hash_name(name);
+            if(find_named(name, h) != npos)
+                return;
+
+            m_named_args.push_back(named_entry{
+                store_name(name),
+                name.size(),
+                format_arg_type(PAPILIO_NS forward_like<T>(val.value)),
+                h
+            });
+            on_named_inserted();
         }
         else
         {
@@ -1940,10 +2453,10 @@ public:
     [[nodiscard]]
     const format_arg_type& get(string_view_type key) const override
     {
-        auto it = m_named_args.find(key);
-        if(it == m_named_args.end())
+        const size_type idx = find_named(key, hash_name(key));
+        if(idx == npos)
             this->throw_invalid_named_argument();
-        return it->second;
+        return m_named_args[idx].value;
     }
 
     using my_base::get;
@@ -1951,7 +2464,7 @@ public:
     [[nodiscard]]
     bool contains(string_view_type key) const noexcept override
     {
-        return m_named_args.contains(key);
+        return find_named(key, hash_name(key)) != npos;
     }
 
     using my_base::contains;
@@ -1962,10 +2475,98 @@ public:
         return m_indexed_args;
     }
 
+    /**
+     * @brief View of the named arguments in insertion order.
+     *
+     * The elements are pairs of the name and the argument.
+     */
+    class named_view
+    {
+    public:
+        using value_type = std::pair<string_view_type, const format_arg_type&>;
+
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = named_view::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator() noexcept = default;
+
+            iterator(const basic_dynamic_format_args* args, size_type idx) noexcept
+                : m_args(args), m_idx(idx) {}
+
+            bool operator==(const iterator& rhs) const noexcept = default;
+
+            reference operator*() const noexcept
+            {
+                const named_entry& e = m_args->m_named_args[m_idx];
+                return value_type(m_args->name_of(e), e.value);
+            }
+
+            iterator& operator++() noexcept
+            {
+                ++m_idx;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+        private:
+            const basic_dynamic_format_args* m_args = nullptr;
+            size_type m_idx = 0;
+        };
+
+        explicit named_view(const basic_dynamic_format_args& args) noexcept
+            : m_args(&args) {}
+
+        [[nodiscard]]
+        iterator begin() const noexcept
+        {
+            return iterator(m_args, 0);
+        }
+
+        [[nodiscard]]
+        iterator end() const noexcept
+        {
+            return iterator(m_args, size());
+        }
+
+        [[nodiscard]]
+        size_type size() const noexcept
+        {
+            return m_args->m_named_args.size();
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        const basic_dynamic_format_args* m_args;
+    };
+
+    /**
+     * @brief Get the named arguments in insertion order without copying them.
+     *
+     * @note The view is invalidated by adding arguments or clearing.
+     * It replaces the map sorted by names returned by previous versions.
+     */
     [[nodiscard]]
-    const map_type& named() const noexcept
+    named_view named() const noexcept
     {
-        return m_named_args;
+        return named_view(*this);
     }
 
     [[nodiscard]]
@@ -1984,11 +2585,107 @@ public:
     {
         m_indexed_args.clear();
         m_named_args.clear();
+        m_names.clear();
+        m_slots.clear();
     }
 
 private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // Named arguments are searched linearly (by comparing the hashes first)
+    // until the count exceeds this limit, then an open-addressing index is built.
+    static constexpr size_type linear_search_limit = 8;
+
+    struct named_entry
+    {
+        // Position of the name in the arena
+        size_type name_offset;
+        size_type name_size;
+        format_arg_type value;
+        std::size_t hash;
+    };
+
     vector_type m_indexed_args;
-    map_type m_named_args;
+    small_vector<named_entry, 4> m_named_args;
+    // Arena of the names
+    std::vector<char_type> m_names;
+    // Slots of the hash index. Each one stores the index of entry plus one, or zero if empty.
+    std::vector<std::uint32_t> m_slots;
+
+    [[nodiscard]]
+    static std::size_t hash_name(string_view_type name) noexcept
+    {
+        return std::hash<string_view_type>{}(name);
+    }
+
+    [[nodiscard]]
+    size_type find_named(string_view_type key, std::size_t h) const noexcept
+    {
+        if(m_slots.empty())
+        {
+            for(size_type i = 0; i < m_named_args.size(); ++i)
+            {
+                const named_entry& e = m_named_args[i];
+                if(e.hash == h && name_of(e) == key)
+                    return i;
+            }
+
+            return npos;
+        }
+
+        const size_type mask = m_slots.size() - 1;
+        for(size_type pos = h & mask;; pos = (pos + 1) & mask)
+        {
+            const std::uint32_t slot = m_slots[pos];
+            if(slot == 0)
+                return npos;
+
+            const named_entry& e = m_named_args[slot - 1];
+            if(e.hash == h && name_of(e) == key)
+                return slot - 1;
+        }
+    }
+
+    [[nodiscard]]
+    string_view_type name_of(const named_entry& e) const noexcept
+    {
+        return string_view_type(m_names.data() + e.name_offset, e.name_size);
+    }
+
+    // Returns the offset of the stored name
+    size_type store_name(string_view_type name)
+    {
+        const size_type offset = m_names.size();
+        m_names.insert(m_names.end(), name.begin(), name.end());
+
+        return offset;
+    }
+
+    void on_named_inserted()
+    {
+        const size_type count = m_named_args.size();
+        if(count <= linear_search_limit)
+            return;
+
+        // Keep the load factor not greater than 1/2
+        if(count * 2 > m_slots.size())
+        {
+            m_slots.assign(std::bit_ceil(count * 4), 0);
+            for(size_type i = 0; i < count; ++i)
+                insert_slot(i);
+        }
+        else
+            insert_slot(count - 1);
+    }
+
+    void insert_slot(size_type idx) noexcept
+    {
+        const size_type mask = m_slots.size() - 1;
+        size_type pos = m_named_args[idx].hash & mask;
+        while(m_slots[pos] != 0)
+            pos = (pos + 1) & mask;
+        m_slots[pos] = static_cast<std::uint32_t>(idx + 1);
+    }
 };
 
 /**
@@ -2042,6 +2739,12 @@ public:
         return m_ptr->named_size();
     }
 
+    [[nodiscard]]
+    const format_arg_type* get_named_at(size_type slot) const noexcept override
+    {
+        return m_ptr->get_named_at(slot);
+    }
+
     [[nodiscard]]
     bool contains(string_view_type k) const noexcept override
     {
@@ -2192,6 +2895,88 @@ concept streamable =
         } -> std::convertible_to<std::basic_ostream<CharT>&>;
     };
 
+namespace detail
+{
+    /**
+     * @brief Stream buffer collecting characters into chunks and passing them to a sink.
+     *
+     * Characters are written into a buffer on the stack,
+     * so the sink is called once per chunk instead of once per character.
+     * Long strings written by `xsputn` are passed to the sink directly.
+     *
+     * @tparam Sink Callable with signature `void(const CharT* first, const CharT* last)`
+     */
+    template <typename CharT, typename Sink>
+    class chunked_streambuf final : public std::basic_streambuf<CharT>
+    {
+        using my_base = std::basic_streambuf<CharT>;
+
+    public:
+        using int_type = typename my_base::int_type;
+        using traits_type = typename my_base::traits_type;
+
+        explicit chunked_streambuf(Sink sink) noexcept(std::is_nothrow_move_constructible_v<Sink>)
+            : m_sink(std::move(sink))
+        {
+            this->setp(m_chunk, m_chunk + chunk_size);
+        }
+
+        chunked_streambuf(const chunked_streambuf&) = delete;
+
+        /**
+         * @brief Pass the remaining characters to the sink.
+         */
+        void flush()
+        {
+            if(this->pptr() != this->pbase())
+                m_sink(static_cast<const CharT*>(this->pbase()), static_cast<const CharT*>(this->pptr()));
+            this->setp(m_chunk, m_chunk + chunk_size);
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            flush();
+            if(!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                *this->pptr() = traits_type::to_char_type(c);
+                this->pbump(1);
+            }
+
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const CharT* s, std::streamsize count) override
+        {
+            const std::streamsize avail = this->epptr() - this->pptr();
+            if(count <= avail)
+            {
+                traits_type::copy(this->pptr(), s, static_cast<std::size_t>(count));
+                this->pbump(static_cast<int>(count));
+            }
+            else
+            {
+                flush();
+                m_sink(s, s + count);
+            }
+
+            return count;
+        }
+
+        int sync() override
+        {
+            flush();
+            return 0;
+        }
+
+    private:
+        static constexpr std::size_t chunk_size = 256;
+
+        Sink m_sink;
+        CharT m_chunk[chunk_size];
+    };
+} // namespace detail
+
 PAPILIO_EXPORT template <typename T, typename CharT>
 requires streamable<T, CharT>
 class streamable_formatter
@@ -2424,47 +3209,465 @@ private:
 };
 
 /**
- * @brief Traits for the format context.
+ * @brief Character buffer with inline storage, which can be used as the output of formatting.
  *
- * It is useful to implement formatters for user-defined types.
+ * Contents with no more than `InlineSize` characters are stored inside the buffer object,
+ * so short messages can be formatted without any dynamic allocation.
+ * Calling `clear()` keeps the memory, which makes the buffer reusable across formatting calls.
  *
- * @sa basic_format_context
+ * @code{.cpp}
+ * papilio::memory_buffer buf;
+ * papilio::format_to(buf, "{} + {} = {}", 1, 2, 3);
+ * buf.view(); // Returns "1 + 2 = 3"
+ * @endcode
  *
- * @tparam Context Context type
+ * @tparam CharT Character type
+ * @tparam InlineSize Size of the inline storage
  */
-PAPILIO_EXPORT template <typename Context>
-class format_context_traits
+PAPILIO_EXPORT template <typename CharT, std::size_t InlineSize>
+class basic_memory_buffer
 {
 public:
-    using char_type = typename Context::char_type;
-    using int_type = std::uint32_t;
-    using string_type = std::basic_string<char_type>;
-    using string_view_type = std::basic_string_view<char_type>;
-    using context_type = Context;
-    using iterator = typename Context::iterator;
-    using format_arg_type = format_arg;
-    using format_args_type = typename Context::format_args_type;
-
-    template <typename T>
-    using formatter_type = typename Context::template formatter_type<T>;
-
-    template <typename AnotherOutputIt>
-    static constexpr bool has_rebind() noexcept
-    {
-        return requires {
-            typename Context::template rebind<AnotherOutputIt>;
-        };
-    }
+    using value_type = CharT;
+    using char_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = CharT&;
+    using const_reference = const CharT&;
+    using pointer = CharT*;
+    using const_pointer = const CharT*;
+    using iterator = CharT*;
+    using const_iterator = const CharT*;
+    using string_type = std::basic_string<CharT>;
+    using string_view_type = std::basic_string_view<CharT>;
 
     /**
-     * @brief Check if context supports locale
+     * @brief Output iterator for appending characters to the buffer.
      */
-    static constexpr bool use_locale() noexcept
+    class appender
     {
-        return requires(context_type& ctx) {
-            { ctx.getloc() } -> std::convertible_to<std::locale>;
-        };
-    }
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        explicit appender(basic_memory_buffer& buf) noexcept
+            : m_buf(std::addressof(buf)) {}
+
+        appender& operator=(const CharT& ch)
+        {
+            m_buf->push_back(ch);
+            return *this;
+        }
+
+        appender& operator*() noexcept
+        {
+            return *this;
+        }
+
+        appender& operator++() noexcept
+        {
+            return *this;
+        }
+
+        appender operator++(int) noexcept
+        {
+            return *this;
+        }
+
+        /**
+         * @brief Get the underlying buffer.
+         */
+        [[nodiscard]]
+        basic_memory_buffer& container() const noexcept
+        {
+            return *m_buf;
+        }
+
+    private:
+        basic_memory_buffer* m_buf;
+    };
+
+    basic_memory_buffer() noexcept = default;
+    basic_memory_buffer(const basic_memory_buffer&) = default;
+    basic_memory_buffer(basic_memory_buffer&&) noexcept = default;
+
+    explicit basic_memory_buffer(string_view_type str)
+    {
+        append(str);
+    }
+
+    basic_memory_buffer& operator=(const basic_memory_buffer&) = default;
+    basic_memory_buffer& operator=(basic_memory_buffer&&) noexcept = default;
+
+    [[nodiscard]]
+    static constexpr size_type inline_size() noexcept
+    {
+        return InlineSize;
+    }
+
+    /**
+     * @brief Check if the contents are stored in dynamically allocated memory.
+     */
+    [[nodiscard]]
+    bool dynamic_allocated() const noexcept
+    {
+        return m_buf.dynamic_allocated();
+    }
+
+    [[nodiscard]]
+    pointer data() noexcept
+    {
+        return m_buf.data();
+    }
+
+    [[nodiscard]]
+    const_pointer data() const noexcept
+    {
+        return m_buf.data();
+    }
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+        return m_buf.size();
+    }
+
+    [[nodiscard]]
+    size_type capacity() const noexcept
+    {
+        return m_buf.capacity();
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept
+    {
+        return m_buf.empty();
+    }
+
+    reference operator[](size_type i) noexcept
+    {
+        return m_buf[i];
+    }
+
+    const_reference operator[](size_type i) const noexcept
+    {
+        return m_buf[i];
+    }
+
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    iterator end() noexcept
+    {
+        return data() + size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + size();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    /**
+     * @brief Get an output iterator appending to this buffer.
+     */
+    [[nodiscard]]
+    appender out() noexcept
+    {
+        return appender(*this);
+    }
+
+    void reserve(size_type n)
+    {
+        m_buf.reserve(n);
+    }
+
+    void resize(size_type count)
+    {
+        m_buf.resize(count, CharT());
+    }
+
+    /**
+     * @brief Remove all characters. The allocated memory is kept for reusing.
+     */
+    void clear() noexcept
+    {
+        m_buf.clear();
+    }
+
+    void push_back(CharT ch)
+    {
+        m_buf.push_back(ch);
+    }
+
+    void append(string_view_type str)
+    {
+        insert(cend(), str.data(), str.data() + str.size());
+    }
+
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator where, InputIt first, InputIt last)
+    {
+        if constexpr(std::forward_iterator<InputIt>)
+        {
+            const size_type off = static_cast<size_type>(where - cbegin());
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            if(size() + count > capacity())
+            {
+                // Growing frees the old storage, so copy the source first if it is inside the buffer.
+                if(overlaps(first, count))
+                {
+                    string_type tmp(first, last);
+                    return insert(cbegin() + off, tmp.begin(), tmp.end());
+                }
+
+                grow(size() + count);
+            }
+
+            const size_type old_size = size();
+            m_buf.append_range(std::ranges::subrange(first, last));
+            if(off != old_size)
+                std::rotate(begin() + off, begin() + old_size, end());
+
+            return begin() + off;
+        }
+        else
+        {
+            string_type tmp(first, last);
+            return insert(where, tmp.begin(), tmp.end());
+        }
+    }
+
+    iterator insert(const_iterator where, size_type count, CharT ch)
+    {
+        const size_type off = static_cast<size_type>(where - cbegin());
+        const size_type old_size = size();
+        if(old_size + count > capacity())
+            grow(old_size + count);
+
+        m_buf.resize(old_size + count, ch);
+        if(off != old_size)
+            std::rotate(begin() + off, begin() + old_size, end());
+
+        return begin() + off;
+    }
+
+    [[nodiscard]]
+    string_view_type view() const noexcept
+    {
+        return string_view_type(data(), size());
+    }
+
+    [[nodiscard]]
+    string_type str() const
+    {
+        return string_type(data(), size());
+    }
+
+private:
+    small_vector<CharT, InlineSize> m_buf;
+
+    void grow(size_type new_size)
+    {
+        reserve(std::max(new_size, capacity() + capacity() / 2));
+    }
+
+    // Check if the source range of an insertion is inside the buffer.
+    template <typename InputIt>
+    bool overlaps(InputIt first, size_type count) const noexcept
+    {
+        if constexpr(std::contiguous_iterator<InputIt>)
+        {
+            if(count == 0)
+                return false;
+
+            const auto* ptr = std::to_address(first);
+            std::less<const void*> less;
+            return !less(ptr, data()) && less(ptr, data() + size());
+        }
+        else
+            return false;
+    }
+};
+
+PAPILIO_EXPORT using memory_buffer = basic_memory_buffer<char>;
+PAPILIO_EXPORT using wmemory_buffer = basic_memory_buffer<wchar_t>;
+
+namespace detail
+{
+    /**
+     * @brief Containers which can append a range or repeated characters by a single call.
+     */
+    template <typename Container, typename CharT>
+    concept bulk_appendable_container =
+        std::same_as<typename Container::value_type, CharT> &&
+        requires(Container& c, const CharT* ptr, std::size_t count, CharT ch) {
+            c.insert(c.end(), ptr, ptr);
+            c.insert(c.end(), count, ch);
+        };
+
+    template <typename OutputIt, typename CharT>
+    struct is_bulk_back_inserter : public std::false_type
+    {};
+
+    template <typename Container, typename CharT>
+    requires bulk_appendable_container<Container, CharT>
+    struct is_bulk_back_inserter<std::back_insert_iterator<Container>, CharT> : public std::true_type
+    {};
+
+    // Output iterators exposing their containers, e.g., the appender of basic_memory_buffer.
+    template <typename OutputIt, typename CharT>
+    requires requires(const OutputIt& it) {
+        requires bulk_appendable_container<std::remove_cvref_t<decltype(it.container())>, CharT>;
+    }
+    struct is_bulk_back_inserter<OutputIt, CharT> : public std::true_type
+    {};
+
+    /**
+     * @brief Output iterators only counting the characters, e.g., the output of `formatted_size`.
+     */
+    template <typename OutputIt>
+    concept size_counting_iterator =
+        requires(OutputIt& it, const OutputIt& c_it, std::size_t n) {
+            it.add_count(n);
+            { c_it.get_result() } -> std::same_as<std::size_t>;
+        };
+
+    /**
+     * @brief Output iterators with a limited capacity, e.g., the output of `format_to_n`.
+     *
+     * They can report the remaining capacity and write characters by a single call.
+     */
+    template <typename OutputIt, typename CharT>
+    concept bounded_output_iterator =
+        requires(OutputIt& it, const OutputIt& c_it, const CharT* ptr, std::size_t count, CharT ch) {
+            { c_it.remaining() } -> std::integral;
+            it.write(ptr, count);
+            it.fill(count, ch);
+        };
+
+    /**
+     * @brief Get the container of a `std::back_insert_iterator`.
+     */
+    template <typename Container>
+    Container& get_container(std::back_insert_iterator<Container> it) noexcept
+    {
+        // The protected member "container" is specified by the standard.
+        struct accessor : public std::back_insert_iterator<Container>
+        {
+            accessor(std::back_insert_iterator<Container> base) noexcept
+                : std::back_insert_iterator<Container>(base) {}
+
+            using std::back_insert_iterator<Container>::container;
+        };
+
+        return *accessor(it).container;
+    }
+
+    template <typename OutputIt>
+    requires requires(const OutputIt& it) { it.container(); }
+    decltype(auto) get_container(const OutputIt& it) noexcept
+    {
+        return it.container();
+    }
+} // namespace detail
+
+/**
+ * @brief Traits for the format context.
+ *
+ * It is useful to implement formatters for user-defined types.
+ *
+ * @sa basic_format_context
+ *
+ * @tparam Context Context type
+ */
+PAPILIO_EXPORT template <typename Context>
+class format_context_traits
+{
+public:
+    using char_type = typename Context::char_type;
+    using int_type = std::uint32_t;
+    using string_type = std::basic_string<char_type>;
+    using string_view_type = std::basic_string_view<char_type>;
+    using context_type = Context;
+    using iterator = typename Context::iterator;
+    using format_arg_type = format_arg;
+    using format_args_type = typename Context::format_args_type;
+
+    template <typename T>
+    using formatter_type = typename Context::template formatter_type<T>;
+
+    /**
+     * @brief Check if the output iterator appends to a container that supports bulk insertion.
+     *
+     * If true, strings and repeated characters will be appended by a single insertion
+     * instead of writing the output iterator character by character.
+     */
+    static constexpr bool bulk_output() noexcept
+    {
+        return detail::is_bulk_back_inserter<iterator, char_type>::value;
+    }
+
+    /**
+     * @brief Check if the output only counts the characters.
+     *
+     * If true, appending characters only adds their count,
+     * and formatters can skip generating the characters whose count is already known.
+     */
+    static constexpr bool size_only() noexcept
+    {
+        return detail::size_counting_iterator<iterator>;
+    }
+
+    /**
+     * @brief Check if the output has a limited capacity.
+     *
+     * If true, the characters beyond the capacity will be discarded,
+     * and formatters can query the remaining capacity to stop early.
+     *
+     * @sa remaining
+     */
+    static constexpr bool bounded_output() noexcept
+    {
+        return detail::bounded_output_iterator<iterator, char_type>;
+    }
+
+    template <typename AnotherOutputIt>
+    static constexpr bool has_rebind() noexcept
+    {
+        return requires {
+            typename Context::template rebind<AnotherOutputIt>;
+        };
+    }
+
+    /**
+     * @brief Check if context supports locale
+     */
+    static constexpr bool use_locale() noexcept
+    {
+        return requires(context_type& ctx) {
+            { ctx.getloc() } -> std::convertible_to<std::locale>;
+        };
+    }
 
     template <typename AnotherOutputIt>
     requires(has_rebind<AnotherOutputIt>())
@@ -2629,16 +3832,87 @@ public:
     }
 
     /**
-     * @brief Append content from an iterator range `[begin, end)`.
+     * @brief Get the number of characters that can still be written to the output.
      *
-     * @param ctx Format context
-     * @param begin Begin iterator
-     * @param end End iterator
+     * @return std::size_t The remaining capacity, or the max value of `std::size_t` if the output is unbounded.
      */
-    template <typename InputIt>
+    [[nodiscard]]
+    static std::size_t remaining(context_type& ctx)
+    {
+        if constexpr(bounded_output())
+            return static_cast<std::size_t>(out(ctx).remaining());
+        else
+            return std::numeric_limits<std::size_t>::max();
+    }
+
+    /**
+     * @brief Count characters without producing them.
+     *
+     * @note The output must be size-only. @sa size_only
+     */
+    static void add_count(context_type& ctx, std::size_t n)
+        requires(size_only())
+    {
+        iterator it = out(ctx);
+        it.add_count(n);
+        advance_to(ctx, std::move(it));
+    }
+
+    /**
+     * @brief Check if nothing more can be written to the output.
+     */
+    [[nodiscard]]
+    static bool exhausted(context_type& ctx)
+    {
+        if constexpr(bounded_output())
+            return remaining(ctx) == 0;
+        else
+            return false;
+    }
+
+    /**
+     * @brief Append content from an iterator range `[begin, end)`.
+     *
+     * @param ctx Format context
+     * @param begin Begin iterator
+     * @param end End iterator
+     */
+    template <typename InputIt>
     static void append(context_type& ctx, InputIt begin, InputIt end)
     {
-        advance_to(ctx, std::copy(begin, end, out(ctx)));
+        if constexpr(size_only() && std::forward_iterator<InputIt>)
+        {
+            add_count(ctx, static_cast<std::size_t>(std::distance(begin, end)));
+        }
+        else if constexpr(bounded_output())
+        {
+            iterator it = out(ctx);
+            if constexpr(std::contiguous_iterator<InputIt> &&
+                         std::same_as<std::iter_value_t<InputIt>, char_type>)
+            {
+                it.write(std::to_address(begin), static_cast<std::size_t>(end - begin));
+            }
+            else
+            {
+                for(; begin != end && it.remaining() > 0; ++begin)
+                {
+                    *it = *begin;
+                    ++it;
+                }
+            }
+            advance_to(ctx, std::move(it));
+        }
+        else if constexpr(bulk_output() &&
+                     std::contiguous_iterator<InputIt> &&
+                     std::same_as<std::iter_value_t<InputIt>, char_type>)
+        {
+            auto& c = detail::get_container(out(ctx));
+            c.insert(c.end(), std::to_address(begin), std::to_address(end));
+        }
+        else
+        {
+            advance_to(ctx, std::copy(begin, end, out(ctx)));
+        }
     }
 
     /**
@@ -2668,10 +3942,28 @@ public:
     {
         if constexpr(sizeof(Char) <= sizeof(char_type))
         {
-            advance_to(
-                ctx,
-                std::fill_n(out(ctx), count, static_cast<char_type>(ch))
-            );
+            if constexpr(size_only())
+            {
+                add_count(ctx, count);
+            }
+            else if constexpr(bounded_output())
+            {
+                iterator it = out(ctx);
+                it.fill(count, static_cast<char_type>(ch));
+                advance_to(ctx, std::move(it));
+            }
+            else if constexpr(bulk_output())
+            {
+                auto& c = detail::get_container(out(ctx));
+                c.insert(c.end(), count, static_cast<char_type>(ch));
+            }
+            else
+            {
+                advance_to(
+                    ctx,
+                    std::fill_n(out(ctx), count, static_cast<char_type>(ch))
+                );
+            }
         }
         else
         {
@@ -2689,9 +3981,49 @@ public:
      */
     static void append(context_type& ctx, utf::codepoint cp, std::size_t count = 1)
     {
-        for(std::size_t i = 0; i < count; ++i)
+        if constexpr(size_only())
+        {
+            char_type buf[4];
+            const std::size_t size = static_cast<std::size_t>(cp.append_to_as<char_type>(buf) - buf);
+            add_count(ctx, size * count);
+        }
+        else if constexpr(bounded_output())
+        {
+            char_type buf[4];
+            const std::size_t size = static_cast<std::size_t>(cp.append_to_as<char_type>(buf) - buf);
+
+            iterator it = out(ctx);
+            if(size == 1)
+                it.fill(count, buf[0]);
+            else
+            {
+                for(std::size_t i = 0; i < count && it.remaining() > 0; ++i)
+                    it.write(buf, size);
+            }
+            advance_to(ctx, std::move(it));
+        }
+        else if constexpr(bulk_output())
+        {
+            // Encode the code point only once
+            char_type buf[4];
+            const std::size_t size = static_cast<std::size_t>(cp.append_to_as<char_type>(buf) - buf);
+
+            auto& c = detail::get_container(out(ctx));
+            if(size == 1)
+            {
+                c.insert(c.end(), count, buf[0]);
+                return;
+            }
+
+            for(std::size_t i = 0; i < count; ++i)
+                c.insert(c.end(), buf, buf + size);
+        }
+        else
         {
-            advance_to(ctx, cp.append_to_as<char_type>(out(ctx)));
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                advance_to(ctx, cp.append_to_as<char_type>(out(ctx)));
+            }
         }
     }
 
@@ -2712,6 +4044,9 @@ public:
     {
         for(std::size_t i = 0; i < count; ++i)
         {
+            if(exhausted(ctx))
+                break;
+
             std::uint32_t ch = static_cast<char32_t>(cp);
             if(has_esc_seq<false, true>(ch))
             {
@@ -2734,7 +4069,7 @@ private:
         requires(char8_like<char_type>)
     {
         std::size_t i = 0;
-        while(i < str.size())
+        while(i < str.size() && !exhausted(ctx))
         {
             if(PAPILIO_NS utf::is_leading_byte(str[i]))
             {
@@ -2797,7 +4132,7 @@ private:
         requires(char16_like<char_type>)
     {
         std::size_t i = 0;
-        while(i < str.size())
+        while(i < str.size() && !exhausted(ctx))
         {
             std::uint16_t ch = static_cast<std::uint16_t>(str[i]);
             if(has_esc_seq<true, false>(ch))
@@ -2844,6 +4179,9 @@ private:
     {
         for(char_type ch : str)
         {
+            if(exhausted(ctx))
+                break;
+
             if(has_esc_seq<true, false>(static_cast<std::uint32_t>(ch)))
             {
                 append_as_esc_seq<true, false>(ctx, static_cast<std::uint32_t>(ch));
@@ -3300,6 +4638,33 @@ struct formatter_traits
         else
             return false;
     }
+
+    /**
+     * @brief Returns true if the formatter can format a contiguous sequence of values by a single call
+     *
+     * @note The result of `format_range` must be the same as formatting the values one by one with the separator.
+     */
+    template <typename T, typename FormatContext>
+    static constexpr bool has_format_range() noexcept
+    {
+        return requires(const Formatter& fmt, std::span<const T> vals, string_view_type sep, FormatContext& fmt_ctx) {
+            { fmt.format_range(vals, sep, fmt_ctx) } -> std::same_as<bool>;
+        };
+    }
+
+    /**
+     * @brief Format values separated by `sep` if the formatter supports it.
+     *
+     * @return true if the values have been formatted
+     */
+    template <typename T, typename FormatContext>
+    static bool try_format_range(const Formatter& fmt, std::span<const T> vals, string_view_type sep, FormatContext& fmt_ctx)
+    {
+        if constexpr(has_format_range<T, FormatContext>())
+            return fmt.format_range(vals, sep, fmt_ctx);
+        else
+            return false;
+    }
 };
 
 /// @}
@@ -3356,6 +4721,46 @@ concept formattable = formattable_with<
     std::remove_const_t<T>,
     basic_format_context<format_iterator_for<CharT>, CharT>>;
 
+namespace detail
+{
+    // Finds the end of a field that will be executed by the interpreter.
+    // The returned position is after the closing brace, or the end of string if the field is unenclosed.
+    template <typename CharT>
+    constexpr std::size_t find_interpreted_field_end(std::basic_string_view<CharT> fmt, std::size_t pos) noexcept
+    {
+        std::size_t depth = 0;
+        while(pos < fmt.size())
+        {
+            const CharT ch = fmt[pos];
+            ++pos;
+
+            if(ch == CharT('\''))
+            {
+                // Skip the string constant
+                while(pos < fmt.size())
+                {
+                    const CharT str_ch = fmt[pos];
+                    ++pos;
+                    if(str_ch == CharT('\\'))
+                        ++pos;
+                    else if(str_ch == CharT('\''))
+                        break;
+                }
+            }
+            else if(ch == CharT('{'))
+                ++depth;
+            else if(ch == CharT('}'))
+            {
+                if(depth == 0)
+                    return pos;
+                --depth;
+            }
+        }
+
+        return fmt.size();
+    }
+} // namespace detail
+
 /// @defgroup Script The embedded script
 /// @ingroup Format
 /// @{
@@ -3411,6 +4816,20 @@ public:
     [[nodiscard]]
     static error make_error(script_error_code ec);
 
+    /**
+     * @brief Enable or disable the cache of compiled scripts.
+     *
+     * Scripted fields are compiled on first use and the results are cached by the script text.
+     * The cache is enabled by default. When disabled, scripts are parsed every time they are executed.
+     */
+    static void enable_script_cache(bool enable) noexcept;
+
+    /**
+     * @brief Check if the cache of compiled scripts is enabled.
+     */
+    [[nodiscard]]
+    static bool script_cache_enabled() noexcept;
+
 #ifndef PAPILIO_DOXYGEN // Don't generate documentation for internal APIs
 
 protected:
@@ -3542,6 +4961,26 @@ protected:
         return start;
     }
 
+    // Same as find_field_name_end(), but also computes the id of the attribute name in the same pass.
+    static std::pair<iterator, std::uint32_t> find_attribute_name_end(iterator start, iterator stop) noexcept
+    {
+        std::uint32_t id = detail::attribute_hash_basis;
+        bool first = true;
+        while(start != stop)
+        {
+            if(!is_field_name_ch(*start, first))
+                break;
+            first = false;
+
+            const CharT* unit = start.base();
+            ++start;
+            for(; unit != start.base(); ++unit)
+                id = detail::attribute_hash_step(id, *unit);
+        }
+
+        return std::make_pair(start, id);
+    }
+
     static std::pair<op_id, iterator> parse_op(iterator start, iterator stop)
     {
         if(start == stop) [[unlikely]]
@@ -3804,85 +5243,468 @@ protected:
         throw_error(script_error_code::invalid_index, start);
     }
 
-#endif
-};
+    // Parses a constant operand of a condition, i.e. a string literal or a number.
+    static std::pair<variable_type, iterator> parse_constant(iterator start, iterator stop)
+    {
+        if(start == stop) [[unlikely]]
+            throw_end_of_string();
 
-/**
- * @brief The interpreter of format specification and embedded script
- *
- * @tparam FormatContext Format context @ref basic_format_context
- * @tparam Debug Enable debug options which can produce more precise error information.
- */
-PAPILIO_EXPORT template <typename FormatContext, bool Debug>
-class basic_interpreter :
-    public basic_interpreter_base<typename FormatContext::char_type, Debug>
-{
-    using my_base = basic_interpreter_base<typename FormatContext::char_type, Debug>;
+        char32_t first_ch = *start;
+        if(first_ch == U'\'')
+        {
+            ++start;
+            auto [str, next_it] = parse_string(start, stop);
 
-public:
-    using char_type = typename FormatContext::char_type;
-    using variable_type = basic_variable<char_type>;
-    using string_view_type = std::basic_string_view<char_type>;
-    using string_ref_type = utf::basic_string_ref<char_type>;
-    using string_container_type = utf::basic_string_container<char_type>;
-    using indexing_value_type = basic_indexing_value<char_type>;
-    using format_arg_type = basic_format_arg<FormatContext>;
+            return std::make_pair(std::move(str), next_it);
+        }
+        else if(first_ch == U'-' || PAPILIO_NS utf::is_digit(first_ch) || first_ch == U'.')
+        {
+            bool negative = first_ch == U'-';
 
-    using parse_context = basic_format_parse_context<FormatContext>;
+            iterator int_end = std::find_if_not(
+                negative ? start + 1 : start, stop, PAPILIO_NS utf::is_digit
+            );
+            using int_type = typename variable_type::int_type;
+            int_type int_val = parse_integer<int_type>(start, int_end).first;
 
-    using iterator = typename my_base::iterator;
-    static_assert(std::same_as<iterator, typename parse_context::iterator>);
+            if(int_end != stop && *int_end == U'.')
+            {
+                ++int_end; // Skip the decimal point
 
-    basic_interpreter() = default;
+                iterator float_end = int_end;
+                int_type pow10_val = 1;
+                for(; float_end != stop; ++float_end)
+                {
+                    if(!PAPILIO_NS utf::is_digit(*float_end))
+                        break;
+                    pow10_val *= 10;
+                }
 
-    /**
-     * @brief Access the format argument
-     *
-     * @param ctx Parse context
-     * @return std::pair<format_arg_type, iterator> The result and the new position of the iterator
-     */
-    static std::pair<format_arg_type, iterator> access(parse_context& ctx)
-    {
-        return access_impl(ctx, ctx.begin(), ctx.end());
+                int_type frac = parse_integer<int_type>(int_end, float_end).first;
+
+                using float_type = typename variable_type::float_type;
+                float_type flt_val = static_cast<float_type>(int_val);
+                flt_val += static_cast<float_type>(frac) / static_cast<float_type>(pow10_val);
+
+                return std::make_pair(flt_val, float_end);
+            }
+            else
+            {
+                return std::make_pair(int_val, int_end);
+            }
+        }
+
+        throw_error(script_error_code::invalid_condition, start);
     }
 
-    class interpreter_context
+    // Compiled form of a scripted field.
+    // Offsets are relative to the beginning of the script (the position after '$'),
+    // so a program can be shared by all format strings containing the same script.
+
+    // A replacement field in the script
+    struct script_field
     {
-    public:
-        using input_iterator = typename parse_context::iterator;
+        std::size_t offset = 0; // Position after '{'
+        std::size_t end = 0;    // Position of the closing '}'
+    };
 
-        interpreter_context() = delete;
+    using script_operand = std::variant<script_field, variable_type>;
 
-        interpreter_context(const interpreter_context&) = default;
+    enum class script_cond : std::uint8_t
+    {
+        none, // The "else" branch
+        test,
+        test_not,
+        compare
+    };
 
-        interpreter_context(parse_context& ictx, FormatContext& octx)
-            : m_parse_ctx(std::addressof(ictx)),
-              m_format_ctx(std::addressof(octx)),
-              m_input_it(ictx.begin()) {}
+    struct script_branch
+    {
+        script_cond cond = script_cond::none;
+        op_id op = op_id::equal;
+        script_operand lhs;
+        script_operand rhs;
 
-        parse_context& input_context() const noexcept
-        {
-            return *m_parse_ctx;
-        }
+        // The branch body is a replacement field if `repl` is true,
+        // otherwise it is the unescaped string literal.
+        bool repl = false;
+        script_field field;
+        string_type literal;
+    };
 
-        FormatContext& output_context() const noexcept
-        {
-            return *m_format_ctx;
-        }
+    struct script_program
+    {
+        std::vector<script_branch> branches;
+        std::size_t end = 0; // Position after the last branch
+    };
 
-        auto parse_begin() const
-        {
-            return m_parse_ctx->begin();
-        }
+    using script_program_ptr = std::shared_ptr<const script_program>;
 
-        auto parse_end() const
-        {
-            return m_parse_ctx->end();
-        }
+    static iterator script_iter_at(std::basic_string_view<CharT> script, std::size_t offset)
+    {
+        return string_ref_type(script.substr(offset)).begin();
+    }
 
-        void input_next()
+    static std::size_t script_offset_of(std::basic_string_view<CharT> script, const iterator& it) noexcept
+    {
+        return static_cast<std::size_t>(it.base() - script.data());
+    }
+
+    // Parses a string literal after checking that it is enclosed,
+    // because an unenclosed one may be followed by the closing brace of the scripted field.
+    static std::pair<string_container_type, iterator> compile_string(iterator start, iterator stop)
+    {
+        bool esc = false;
+        for(iterator it = start; it != stop; ++it)
         {
-            ++m_input_it;
+            char32_t ch = *it;
+            if(esc)
+                esc = false;
+            else if(ch == U'\\')
+                esc = true;
+            else if(ch == U'\'')
+                return parse_string(start, stop);
+        }
+
+        throw_end_of_string();
+    }
+
+    static iterator compile_field(
+        script_field& field, std::basic_string_view<CharT> script, iterator start
+    )
+    {
+        PAPILIO_ASSERT(*start == U'{');
+
+        field.offset = script_offset_of(script, start) + 1;
+        std::size_t field_end = detail::find_interpreted_field_end(script, field.offset);
+        if(field_end == field.offset || script[field_end - 1] != CharT('}')) [[unlikely]]
+            throw_end_of_string();
+        field.end = field_end - 1;
+
+        return script_iter_at(script, field_end);
+    }
+
+    static iterator compile_operand(
+        script_operand& operand, std::basic_string_view<CharT> script, iterator start, iterator stop
+    )
+    {
+        if(start == stop) [[unlikely]]
+            throw_end_of_string();
+
+        char32_t first_ch = *start;
+        if(first_ch == U'{')
+        {
+            script_field field;
+            start = compile_field(field, script, start);
+            operand = field;
+
+            return start;
+        }
+        else if(first_ch == U'\'')
+        {
+            ++start;
+            auto [str, next_it] = compile_string(start, stop);
+
+            // The program outlives the format string, so the string constant must own its data.
+            operand = variable_type(string_container_type(independent, str));
+
+            return next_it;
+        }
+
+        auto [var, next_it] = parse_constant(start, stop);
+        operand = std::move(var);
+
+        return next_it;
+    }
+
+    static iterator compile_condition(
+        script_branch& branch, std::basic_string_view<CharT> script, iterator start, iterator stop
+    )
+    {
+        start = skip_ws(start, stop);
+        if(start == stop) [[unlikely]]
+            throw_end_of_string();
+
+        char32_t first_ch = *start;
+        if(first_ch == U'!')
+        {
+            ++start;
+            start = skip_ws(start, stop);
+
+            start = compile_operand(branch.lhs, script, start, stop);
+            branch.cond = script_cond::test_not;
+        }
+        else if(is_var_start_ch(first_ch))
+        {
+            start = compile_operand(branch.lhs, script, start, stop);
+            start = skip_ws(start, stop);
+            if(start == stop) [[unlikely]]
+                throw_end_of_string();
+
+            if(is_op_ch(*start))
+            {
+                std::tie(branch.op, start) = parse_op(start, stop);
+                start = skip_ws(start, stop);
+
+                start = compile_operand(branch.rhs, script, start, stop);
+                branch.cond = script_cond::compare;
+            }
+            else
+                branch.cond = script_cond::test;
+        }
+        else
+            throw_error(script_error_code::invalid_condition, start);
+
+        start = skip_ws(start, stop);
+        if(start == stop) [[unlikely]]
+            throw_end_of_string();
+        if(*start != condition_end) [[unlikely]]
+            throw_error(script_error_code::invalid_condition, start);
+
+        ++start;
+        return start;
+    }
+
+    static iterator compile_branch(
+        script_branch& branch, std::basic_string_view<CharT> script, iterator start, iterator stop
+    )
+    {
+        start = skip_ws(start, stop);
+        if(start == stop) [[unlikely]]
+            throw_end_of_string();
+
+        if(char32_t ch = *start; ch == U'\'')
+        {
+            ++start;
+
+            string_container_type str;
+            std::tie(str, start) = compile_string(start, stop);
+            branch.literal = string_type(std::basic_string_view<CharT>(str));
+        }
+        else if(ch == U'{')
+        {
+            branch.repl = true;
+            start = compile_field(branch.field, script, start);
+        }
+        else
+            throw_error(script_error_code::invalid_string, start);
+
+        return skip_ws(start, stop);
+    }
+
+    /**
+     * @brief Compile the script.
+     *
+     * @param script The script between '$' and the closing brace of the scripted field.
+     *
+     * @note Only the syntax is checked. Errors of replacement fields are reported when executing the program.
+     */
+    static script_program compile_script(std::basic_string_view<CharT> script)
+    {
+        const string_ref_type script_ref(script);
+        iterator start = script_ref.begin();
+        const iterator stop = script_ref.end();
+
+        script_program prog;
+
+        start = compile_condition(prog.branches.emplace_back(), script, start, stop);
+        start = compile_branch(prog.branches.back(), script, start, stop);
+
+        while(start != stop && *start == U':')
+        {
+            start = skip_ws(std::next(start), stop);
+
+            script_branch& branch = prog.branches.emplace_back();
+            if(start != stop && *start == U'$')
+            {
+                start = skip_ws(std::next(start), stop);
+                start = compile_condition(branch, script, start, stop);
+            }
+
+            start = compile_branch(branch, script, start, stop);
+        }
+
+        prog.end = script_offset_of(script, start);
+        return prog;
+    }
+
+    // Returns nullptr if the script cannot be compiled or the cache is full.
+    // The caller should fall back to interpreting the script, which also reports precise error information.
+    static script_program_ptr get_script_program(std::basic_string_view<CharT> script)
+    {
+        // Recently used scripts of the current thread are looked up without locking
+        front_cache_entry& front = get_front_cache_entry(script);
+        if(front.valid && front.script == script)
+            return front.prog;
+
+        script_cache& cache = get_script_cache();
+
+        {
+            std::shared_lock lock(cache.mutex);
+            auto it = cache.programs.find(script);
+            if(it != cache.programs.end())
+                return front.assign(script, it->second);
+        }
+
+        if(cache.full.load(std::memory_order_relaxed))
+            return front.assign(script, nullptr);
+
+        script_program_ptr prog;
+        try
+        {
+            prog = std::make_shared<const script_program>(compile_script(script));
+
+            // Scripts ending earlier are followed by invalid characters, which are reported by the interpreter.
+            if(prog->end != script.size())
+                prog = nullptr;
+        }
+        catch(const format_error&)
+        {
+            prog = nullptr;
+        }
+
+        // Failures are cached as well, so invalid scripts are not compiled again
+        std::unique_lock lock(cache.mutex);
+        if(cache.programs.size() < script_cache_capacity)
+            cache.programs.try_emplace(string_type(script), prog);
+        else
+            cache.full.store(true, std::memory_order_relaxed);
+
+        return front.assign(script, std::move(prog));
+    }
+
+private:
+    // Stop caching new scripts after this limit to bound the memory usage
+    static constexpr std::size_t script_cache_capacity = 1024;
+
+    // Number of entries of the thread-local cache in front of the shared one
+    static constexpr std::size_t front_cache_size = 16;
+
+    struct script_hash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::basic_string_view<CharT> str) const noexcept
+        {
+            return std::hash<std::basic_string_view<CharT>>()(str);
+        }
+    };
+
+    struct script_cache
+    {
+        std::shared_mutex mutex;
+        // Null programs mark the scripts that cannot be compiled
+        std::unordered_map<string_type, script_program_ptr, script_hash, std::equal_to<>> programs;
+        std::atomic<bool> full = false;
+    };
+
+    struct front_cache_entry
+    {
+        string_type script;
+        script_program_ptr prog;
+        bool valid = false;
+
+        script_program_ptr assign(std::basic_string_view<CharT> new_script, script_program_ptr new_prog)
+        {
+            script.assign(new_script);
+            prog = std::move(new_prog);
+            valid = true;
+
+            return prog;
+        }
+    };
+
+    static front_cache_entry& get_front_cache_entry(std::basic_string_view<CharT> script)
+    {
+        thread_local front_cache_entry entries[front_cache_size];
+        return entries[script_hash()(script) % front_cache_size];
+    }
+
+    static script_cache& get_script_cache()
+    {
+        static script_cache cache;
+        return cache;
+    }
+
+#endif
+};
+
+/**
+ * @brief The interpreter of format specification and embedded script
+ *
+ * @tparam FormatContext Format context @ref basic_format_context
+ * @tparam Debug Enable debug options which can produce more precise error information.
+ */
+PAPILIO_EXPORT template <typename FormatContext, bool Debug>
+class basic_interpreter :
+    public basic_interpreter_base<typename FormatContext::char_type, Debug>
+{
+    using my_base = basic_interpreter_base<typename FormatContext::char_type, Debug>;
+
+public:
+    using char_type = typename FormatContext::char_type;
+    using variable_type = basic_variable<char_type>;
+    using string_view_type = std::basic_string_view<char_type>;
+    using string_ref_type = utf::basic_string_ref<char_type>;
+    using string_container_type = utf::basic_string_container<char_type>;
+    using indexing_value_type = basic_indexing_value<char_type>;
+    using format_arg_type = basic_format_arg<FormatContext>;
+
+    using parse_context = basic_format_parse_context<FormatContext>;
+
+    using iterator = typename my_base::iterator;
+    static_assert(std::same_as<iterator, typename parse_context::iterator>);
+
+    basic_interpreter() = default;
+
+    /**
+     * @brief Access the format argument
+     *
+     * @param ctx Parse context
+     * @return std::pair<format_arg_type, iterator> The result and the new position of the iterator
+     */
+    static std::pair<format_arg_type, iterator> access(parse_context& ctx)
+    {
+        return access_impl(ctx, ctx.begin(), ctx.end());
+    }
+
+    class interpreter_context
+    {
+    public:
+        using input_iterator = typename parse_context::iterator;
+
+        interpreter_context() = delete;
+
+        interpreter_context(const interpreter_context&) = default;
+
+        interpreter_context(parse_context& ictx, FormatContext& octx)
+            : m_parse_ctx(std::addressof(ictx)),
+              m_format_ctx(std::addressof(octx)),
+              m_input_it(ictx.begin()) {}
+
+        parse_context& input_context() const noexcept
+        {
+            return *m_parse_ctx;
+        }
+
+        FormatContext& output_context() const noexcept
+        {
+            return *m_format_ctx;
+        }
+
+        auto parse_begin() const
+        {
+            return m_parse_ctx->begin();
+        }
+
+        auto parse_end() const
+        {
+            return m_parse_ctx->end();
+        }
+
+        void input_next()
+        {
+            ++m_input_it;
         }
 
         void advance_input_to(input_iterator it)
@@ -3963,7 +5785,7 @@ public:
                 intp_ctx.input_next();
 
                 intp_ctx.update_input_context();
-                exec_script(intp_ctx.input_context(), intp_ctx.output_context());
+                exec_compiled_script(intp_ctx.input_context(), intp_ctx.output_context());
 
                 intp_ctx.advance_input_to(intp_ctx.parse_begin());
                 if(intp_ctx.input_at_end()) [[unlikely]]
@@ -4110,6 +5932,47 @@ private:
         }
     }
 
+    /**
+     * @brief Write the string literal to the output
+     *
+     * Characters between escape sequences are appended as slices of the format string,
+     * and escape sequences are decoded directly into the output, so no temporary string is created.
+     *
+     * @return The position after the closing quote
+     */
+    static iterator exec_string(iterator start, iterator stop, FormatContext& fmt_ctx)
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        iterator chunk_start = start;
+        for(; start != stop; ++start)
+        {
+            char32_t ch = *start;
+            if(ch == U'\\')
+            {
+                context_t::append(fmt_ctx, string_view_type(chunk_start.base(), start.base()));
+
+                ++start;
+                if(start == stop) [[unlikely]]
+                    my_base::throw_error(script_error_code::invalid_string, start);
+                context_t::append(fmt_ctx, utf::codepoint(my_base::get_esc_ch(*start)));
+
+                chunk_start = std::next(start);
+            }
+            else if(ch == U'\'')
+            {
+                context_t::append(fmt_ctx, string_view_type(chunk_start.base(), start.base()));
+                ++start; // skip '\''
+
+                return start;
+            }
+        }
+
+        context_t::append(fmt_ctx, string_view_type(chunk_start.base(), start.base()));
+
+        return start;
+    }
+
     static iterator exec_branch(parse_context& parse_ctx, FormatContext& fmt_ctx)
     {
         auto start = parse_ctx.begin();
@@ -4117,18 +5980,10 @@ private:
 
         PAPILIO_ASSERT(start != stop);
 
-        using context_t = format_context_traits<FormatContext>;
-
         if(char32_t ch = *start; ch == U'\'')
         {
             ++start;
-
-            string_container_type str;
-            std::tie(str, start) = my_base::parse_string(start, stop);
-
-            context_t::append(fmt_ctx, str);
-
-            return start;
+            return exec_string(start, stop, fmt_ctx);
         }
         else if(ch == U'{')
         {
@@ -4228,11 +6083,164 @@ private:
     }
 
     /**
-     * @brief Execute the replacement field
+     * @brief Execute the scripted field by its compiled program
+     *
+     * @note Falls back to `exec_script()` if the cache is disabled or the script cannot be compiled.
      */
-    static void exec_repl(parse_context& parse_ctx, FormatContext& fmt_ctx)
+    static void exec_compiled_script(parse_context& parse_ctx, FormatContext& fmt_ctx)
     {
-        auto [arg, next_it] = access(parse_ctx);
+        if(!my_base::script_cache_enabled())
+        {
+            exec_script(parse_ctx, fmt_ctx);
+            return;
+        }
+
+        const auto* first = parse_ctx.begin().base();
+        const string_view_type rest(
+            first, static_cast<std::size_t>(parse_ctx.end().base() - first)
+        );
+
+        std::size_t field_end = detail::find_interpreted_field_end(rest, 0);
+        if(field_end == 0 || rest[field_end - 1] != char_type('}')) [[unlikely]]
+        {
+            exec_script(parse_ctx, fmt_ctx);
+            return;
+        }
+
+        const string_view_type script = rest.substr(0, field_end - 1);
+        auto prog = my_base::get_script_program(script);
+        if(!prog) [[unlikely]]
+        {
+            exec_script(parse_ctx, fmt_ctx);
+            return;
+        }
+
+        // Iterators must be created from the remaining format string instead of the script,
+        // because their valid range is bounded by the string they were created from.
+        exec_program(*prog, rest, parse_ctx, fmt_ctx);
+    }
+
+    template <typename Fn>
+    static decltype(auto) visit_operand(
+        const typename my_base::script_operand& operand,
+        string_view_type script,
+        parse_context& parse_ctx,
+        Fn&& fn
+    )
+    {
+        using field_type = typename my_base::script_field;
+
+        if(const field_type* field = std::get_if<field_type>(&operand))
+        {
+            auto [arg, next_it] = access_impl(
+                parse_ctx, my_base::script_iter_at(script, field->offset), parse_ctx.end()
+            );
+            if(my_base::script_offset_of(script, next_it) != field->end) [[unlikely]]
+                my_base::throw_error(script_error_code::unenclosed_brace, next_it);
+
+            return fn(variable_type(std::move(arg).to_variant()));
+        }
+
+        return fn(std::get<variable_type>(operand));
+    }
+
+    static bool eval_condition(
+        const typename my_base::script_branch& branch,
+        string_view_type script,
+        parse_context& parse_ctx
+    )
+    {
+        using cond_type = typename my_base::script_cond;
+
+        switch(branch.cond)
+        {
+        case cond_type::test:
+        case cond_type::test_not:
+        {
+            bool result = visit_operand(
+                branch.lhs,
+                script,
+                parse_ctx,
+                [](const variable_type& var)
+                { return var.template as<bool>(); }
+            );
+            return branch.cond == cond_type::test ? result : !result;
+        }
+
+        case cond_type::compare:
+            return visit_operand(
+                branch.lhs,
+                script,
+                parse_ctx,
+                [&](const variable_type& lhs)
+                {
+                    return visit_operand(
+                        branch.rhs,
+                        script,
+                        parse_ctx,
+                        [&](const variable_type& rhs)
+                        { return my_base::execute_op(branch.op, lhs, rhs); }
+                    );
+                }
+            );
+
+        case cond_type::none:
+        default:
+            PAPILIO_UNREACHABLE();
+        }
+    }
+
+    static void exec_program(
+        const typename my_base::script_program& prog,
+        string_view_type script,
+        parse_context& parse_ctx,
+        FormatContext& fmt_ctx
+    )
+    {
+        using context_t = format_context_traits<FormatContext>;
+        using cond_type = typename my_base::script_cond;
+
+        bool executed = false;
+        for(const auto& branch : prog.branches)
+        {
+            // Conditions of all branches are evaluated like the interpreter does,
+            // so the arguments are accessed and checked in the same way.
+            bool exec_this_branch = !executed;
+            if(branch.cond != cond_type::none)
+            {
+                exec_this_branch = eval_condition(branch, script, parse_ctx) && !executed;
+                executed |= exec_this_branch;
+            }
+
+            if(branch.repl)
+            {
+                parse_ctx.advance_to(my_base::script_iter_at(script, branch.field.offset));
+                if(exec_this_branch)
+                    exec_repl(parse_ctx, fmt_ctx);
+                else
+                    skip_repl(parse_ctx);
+
+                auto it = parse_ctx.begin();
+                if(it == parse_ctx.end()) [[unlikely]]
+                    my_base::throw_end_of_string();
+                if(*it != U'}' || my_base::script_offset_of(script, it) != branch.field.end) [[unlikely]]
+                    my_base::throw_error(script_error_code::invalid_fmt_spec, it);
+            }
+            else if(exec_this_branch)
+            {
+                context_t::append(fmt_ctx, string_view_type(branch.literal));
+            }
+        }
+
+        parse_ctx.advance_to(my_base::script_iter_at(script, prog.end));
+    }
+
+    /**
+     * @brief Execute the replacement field
+     */
+    static void exec_repl(parse_context& parse_ctx, FormatContext& fmt_ctx)
+    {
+        auto [arg, next_it] = access(parse_ctx);
 
         if(next_it == parse_ctx.end()) [[unlikely]]
             my_base::throw_end_of_string();
@@ -4264,213 +6272,798 @@ private:
                 next_it
             );
         }
-        else if(first_ch == U'\'')
+
+        return my_base::parse_constant(start, stop);
+    }
+
+    static std::pair<bool, iterator> parse_condition(parse_context& ctx, iterator start, iterator stop)
+    {
+        start = my_base::skip_ws(start, stop);
+        if(start == stop) [[unlikely]]
+            my_base::throw_end_of_string();
+
+        char32_t first_ch = *start;
+        if(first_ch == U'!')
         {
             ++start;
-            auto [str, next_it] = my_base::parse_string(start, stop);
+            start = my_base::skip_ws(start, stop);
 
-            return std::make_pair(std::move(str), next_it);
+            auto [var, next_it] = parse_variable(ctx, start, stop);
+            next_it = my_base::skip_ws(next_it, stop);
+            if(next_it == stop) [[unlikely]]
+                my_base::throw_end_of_string();
+            if(*next_it != my_base::condition_end) [[unlikely]]
+                my_base::throw_error(script_error_code::invalid_condition, next_it);
+
+            ++next_it;
+            return std::make_pair(!var.template as<bool>(), next_it);
         }
-        else if(first_ch == U'-' || PAPILIO_NS utf::is_digit(first_ch) || first_ch == U'.')
+        else if(my_base::is_var_start_ch(first_ch))
         {
-            bool negative = first_ch == U'-';
+            auto [var, next_it] = parse_variable(ctx, start, stop);
 
-            iterator int_end = std::find_if_not(
-                negative ? start + 1 : start, stop, PAPILIO_NS utf::is_digit
+            next_it = my_base::skip_ws(next_it, stop);
+            if(next_it == stop) [[unlikely]]
+                my_base::throw_end_of_string();
+
+            char32_t ch = *next_it;
+            if(ch == my_base::condition_end)
+            {
+                ++next_it;
+                return std::make_pair(var.template as<bool>(), next_it);
+            }
+            else if(my_base::is_op_ch(ch))
+            {
+                typename my_base::op_id op{};
+                std::tie(op, next_it) = my_base::parse_op(next_it, stop);
+
+                next_it = my_base::skip_ws(next_it, stop);
+
+                auto [var_2, next_it_2] = parse_variable(ctx, next_it, stop);
+                next_it = my_base::skip_ws(next_it_2, stop);
+
+                if(next_it == stop) [[unlikely]]
+                    my_base::throw_end_of_string();
+                if(*next_it != my_base::condition_end) [[unlikely]]
+                    my_base::throw_error(script_error_code::invalid_condition, next_it);
+
+                ++next_it;
+                return std::make_pair(
+                    my_base::execute_op(op, var, var_2),
+                    next_it
+                );
+            }
+
+            my_base::throw_error(script_error_code::invalid_condition, next_it);
+        }
+
+        my_base::throw_error(script_error_code::invalid_condition, start);
+    }
+
+    static std::pair<format_arg_type, iterator> parse_field_name(
+        parse_context& ctx, iterator start, iterator stop
+    )
+    {
+        if(start == stop) [[unlikely]]
+            my_base::throw_end_of_string();
+
+        if(char32_t first_ch = *start; utf::is_digit(first_ch))
+        {
+            std::size_t idx = static_cast<std::size_t>(first_ch - U'0');
+            ++start;
+
+            while(start != stop)
+            {
+                char32_t ch = *start;
+                if(!utf::is_digit(ch))
+                    break;
+
+                idx *= 10;
+                idx += static_cast<std::size_t>(ch - U'0');
+                ++start;
+            }
+
+            ctx.check_arg_id(idx);
+            return std::make_pair(ctx.get_args()[static_cast<ssize_t>(idx)], start);
+        }
+        else if(my_base::is_field_name_ch(first_ch, true))
+        {
+            iterator str_start = start;
+            ++start;
+            iterator str_end = my_base::find_field_name_end(start, stop, false);
+
+            string_ref_type name(str_start, str_end);
+
+            return std::make_pair(
+                ctx.get_args().get(string_view_type(name)),
+                str_end
             );
-            using int_type = typename variable_type::int_type;
-            int_type int_val = my_base::template parse_integer<int_type>(start, int_end).first;
+        }
+        else if(my_base::is_field_name_end_ch(first_ch)) // use default value
+        {
+            std::size_t idx = ctx.current_arg_id();
+            ctx.next_arg_id();
+            return std::make_pair(ctx.get_args()[static_cast<ssize_t>(idx)], start);
+        }
 
-            if(int_end != stop && *int_end == U'.')
+        my_base::throw_error(script_error_code::invalid_field_name, start);
+    }
+
+    static std::pair<format_arg_type, iterator> parse_chained_access(
+        format_arg_type& base_arg, iterator start, iterator stop
+    )
+    {
+        format_arg_type current = base_arg;
+
+        while(start != stop)
+        {
+            char32_t first_ch = *start;
+            if(first_ch == U'.')
             {
-                ++int_end; // Skip the decimal point
+                ++start;
+                iterator str_start = start;
 
-                iterator float_end = int_end;
-                int_type pow10_val = 1;
-                for(; float_end != stop; ++float_end)
+                auto [str_end, attr_id] = my_base::find_attribute_name_end(start, stop);
+
+                string_ref_type attr_name(str_start, str_end);
+                if(attr_name.empty())
+                    my_base::throw_error(script_error_code::invalid_attribute, str_end);
+
+                current = current.attribute(basic_attribute_name<char_type>(attr_name, attr_id));
+
+                start = str_end;
+            }
+            else if(first_ch == U'[')
+            {
+                ++start;
+                auto [idx, next_it] = my_base::parse_indexing_value(start, stop);
+                if(next_it == stop) [[unlikely]]
+                    my_base::throw_end_of_string();
+                if(*next_it != U']') [[unlikely]]
+                    my_base::throw_error(script_error_code::invalid_index, next_it);
+                ++next_it;
+
+                current = current.index(idx);
+
+                start = next_it;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        return std::make_pair(std::move(current), start);
+    }
+};
+
+/// @}
+
+/// @addtogroup Parse
+/// @{
+
+namespace detail
+{
+    template <typename CharT>
+    constexpr bool is_ascii_digit(CharT ch) noexcept
+    {
+        return CharT('0') <= ch && ch <= CharT('9');
+    }
+
+    template <typename CharT>
+    constexpr bool is_ascii_name_ch(CharT ch, bool first) noexcept
+    {
+        if(is_ascii_digit(ch))
+            return !first;
+
+        return (CharT('A') <= ch && ch <= CharT('Z')) ||
+               (CharT('a') <= ch && ch <= CharT('z')) ||
+               ch == CharT('_');
+    }
+
+    /**
+     * @brief Split a format string into segments.
+     *
+     * Ordinary text and simple replacement fields are recognized here,
+     * everything else is kept as an interpreted segment for the interpreter.
+     * The callback will be invoked with every segment in order.
+     *
+     * @throw script_base::error If the braces are unenclosed.
+     */
+    template <typename CharT, typename Callback>
+    constexpr void parse_fmt_segments(std::basic_string_view<CharT> fmt, Callback&& cb)
+    {
+        const std::size_t n = fmt.size();
+
+        auto emit_literal = [&cb](std::size_t start, std::size_t stop)
+        {
+            if(start != stop)
+                cb(fmt_segment{.kind = fmt_segment_kind::literal, .offset = start, .size = stop - start});
+        };
+
+        std::size_t lit_start = 0;
+        std::size_t i = 0;
+        while(i < n)
+        {
+            const CharT ch = fmt[i];
+
+            if(ch == CharT('}'))
+            {
+                if(i + 1 == n) [[unlikely]]
+                    throw script_base::make_error(script_error_code::end_of_string);
+                if(fmt[i + 1] != CharT('}')) [[unlikely]]
+                    throw script_base::make_error(script_error_code::unenclosed_brace);
+
+                emit_literal(lit_start, i + 1);
+                i += 2;
+                lit_start = i;
+                continue;
+            }
+            else if(ch != CharT('{'))
+            {
+                ++i;
+                continue;
+            }
+
+            if(i + 1 == n) [[unlikely]]
+                throw script_base::make_error(script_error_code::end_of_string);
+            if(fmt[i + 1] == CharT('{'))
+            {
+                emit_literal(lit_start, i + 1);
+                i += 2;
+                lit_start = i;
+                continue;
+            }
+
+            emit_literal(lit_start, i);
+
+            const std::size_t field_start = i;
+            std::size_t pos = i + 1;
+
+            fmt_segment seg;
+            if(const CharT first_ch = fmt[pos]; is_ascii_digit(first_ch))
+            {
+                seg.kind = fmt_segment_kind::indexed;
+                for(; pos < n && is_ascii_digit(fmt[pos]); ++pos)
                 {
-                    if(!PAPILIO_NS utf::is_digit(*float_end))
+                    seg.arg_id *= 10;
+                    seg.arg_id += static_cast<std::size_t>(fmt[pos] - CharT('0'));
+                }
+            }
+            else if(is_ascii_name_ch(first_ch, true))
+            {
+                seg.kind = fmt_segment_kind::named;
+                seg.arg_id = pos;
+                for(++pos; pos < n && is_ascii_name_ch(fmt[pos], false); ++pos)
+                    ;
+                seg.name_size = pos - seg.arg_id;
+            }
+            else if(first_ch == CharT('}') || first_ch == CharT(':'))
+            {
+                seg.kind = fmt_segment_kind::automatic;
+            }
+            else
+            {
+                seg.kind = fmt_segment_kind::interpreted;
+            }
+
+            if(seg.kind != fmt_segment_kind::interpreted)
+            {
+                if(pos == n) [[unlikely]]
+                    throw script_base::make_error(script_error_code::end_of_string);
+                if(fmt[pos] != CharT('}') && fmt[pos] != CharT(':'))
+                    seg.kind = fmt_segment_kind::interpreted;
+            }
+
+            if(seg.kind == fmt_segment_kind::interpreted)
+            {
+                i = find_interpreted_field_end(fmt, field_start + 1);
+
+                cb(fmt_segment{
+                    .kind = fmt_segment_kind::interpreted,
+                    .offset = field_start,
+                    .size = i - field_start
+                });
+                lit_start = i;
+                continue;
+            }
+
+            if(fmt[pos] == CharT(':'))
+                ++pos;
+            seg.offset = pos;
+
+            // Same rule as the default implementation of skipping format specification
+            std::size_t depth = 0;
+            for(; pos < n; ++pos)
+            {
+                const CharT spec_ch = fmt[pos];
+                if(spec_ch == CharT('{'))
+                {
+                    seg.dynamic_spec = true;
+                    ++depth;
+                }
+                else if(spec_ch == CharT('}'))
+                {
+                    if(depth == 0)
                         break;
-                    pow10_val *= 10;
+                    --depth;
                 }
+            }
+            if(pos == n) [[unlikely]]
+                throw script_base::make_error(script_error_code::end_of_string);
 
-                int_type frac = my_base::template parse_integer<int_type>(int_end, float_end).first;
+            seg.size = pos - seg.offset;
+            cb(seg);
 
-                using float_type = typename variable_type::float_type;
-                float_type flt_val = static_cast<float_type>(int_val);
-                flt_val += static_cast<float_type>(frac) / static_cast<float_type>(pow10_val);
+            i = pos + 1;
+            lit_start = i;
+        }
+
+        emit_literal(lit_start, n);
+    }
+
+    /**
+     * @brief Category of an argument for checking format strings at compile time.
+     */
+    enum class fmt_arg_category : std::uint8_t
+    {
+        /** Types whose format specification cannot be checked at compile time. */
+        other = 0,
+        named = 1,
+        boolean = 2,
+        character = 3,
+        integer = 4,
+        floating = 5,
+        string = 6
+    };
+
+    template <typename T, typename CharT>
+    consteval fmt_arg_category get_fmt_arg_category() noexcept
+    {
+        using type = std::remove_cvref_t<T>;
+
+        if constexpr(is_named_arg_v<type>)
+            return fmt_arg_category::named;
+        else if constexpr(std::same_as<type, bool>)
+            return fmt_arg_category::boolean;
+        else if constexpr(char_like<type> || std::same_as<type, utf::codepoint>)
+            return fmt_arg_category::character;
+        else if constexpr(acceptable_integral<type>)
+            return fmt_arg_category::integer;
+        else if constexpr(acceptable_fp<type>)
+            return fmt_arg_category::floating;
+        else if constexpr(std::same_as<std::decay_t<type>, CharT*> ||
+                          std::same_as<std::decay_t<type>, const CharT*> ||
+                          std::same_as<type, std::basic_string<CharT>> ||
+                          std::same_as<type, std::basic_string_view<CharT>> ||
+                          std::same_as<type, utf::basic_string_container<CharT>>)
+            return fmt_arg_category::string;
+        else
+            return fmt_arg_category::other;
+    }
+
+    // Category of the value of a named argument, or "other" for the other arguments.
+    template <typename T, typename CharT>
+    consteval fmt_arg_category get_named_fmt_arg_category() noexcept
+    {
+        using type = std::remove_cvref_t<T>;
+
+        if constexpr(is_named_arg_v<type>)
+            return get_fmt_arg_category<typename type::value_type, CharT>();
+        else
+            return fmt_arg_category::other;
+    }
+
+    // Name of a named argument known at compile time, or a null string view.
+    template <typename T, typename CharT>
+    consteval std::basic_string_view<CharT> get_static_arg_name() noexcept
+    {
+        if constexpr(has_static_arg_name<T>)
+        {
+            if constexpr(std::same_as<typename T::char_type, CharT>)
+                return T::static_name;
+            else
+                return std::basic_string_view<CharT>();
+        }
+        else
+            return std::basic_string_view<CharT>();
+    }
+
+    // Format types accepted by the built-in formatter of the category.
+    constexpr std::string_view get_fmt_accepted_types(fmt_arg_category cat) noexcept
+    {
+        switch(cat)
+        {
+        case fmt_arg_category::boolean: return "sXxBbod";
+        case fmt_arg_category::character: return "XxBbodc?";
+        case fmt_arg_category::integer: return "XxBbodc";
+        case fmt_arg_category::floating: return "fFgGeEaA";
+        case fmt_arg_category::string: return "s?";
+
+        default: return "XxBbodcfFgGeEaAs?pP";
+        }
+    }
+
+    /**
+     * @brief Parse a standard format specification at compile time.
+     *
+     * It follows the same rules as the @ref std_formatter_parser.
+     * The specification should not contain any nested replacement field.
+     *
+     * @param out The parsed result. The `has_data` will be false if the result cannot be stored.
+     * @return False if the specification is invalid.
+     */
+    template <typename CharT>
+    constexpr bool parse_static_std_spec(
+        std::basic_string_view<CharT> spec, std::string_view types, fmt_static_segment& out
+    ) noexcept
+    {
+        constexpr std::size_t max_value = std::numeric_limits<std::uint8_t>::max();
+
+        auto is_align_ch = [](CharT ch) -> bool
+        {
+            return ch == CharT('<') || ch == CharT('>') || ch == CharT('^');
+        };
+        auto get_align = [](CharT ch) -> format_align
+        {
+            switch(ch)
+            {
+            case CharT('<'): return format_align::left;
+            case CharT('>'): return format_align::right;
+            default: return format_align::middle;
+            }
+        };
+
+        fmt_static_segment result = out;
+        result.has_data = true;
+
+        const std::size_t n = spec.size();
+        std::size_t pos = 0;
+        // Returns false if the specification is invalid
+        auto parse = [&]() -> bool
+        {
+            if(pos == n)
+                return true;
+
+            {
+                // Code units of the leading code point, which may be the filling character
+                std::size_t fill_size = 1;
+                if constexpr(sizeof(CharT) == 1)
+                {
+                    const auto leading_byte = static_cast<std::uint8_t>(spec[0]);
+                    if(!utf::is_leading_byte(leading_byte))
+                    {
+                        // Leave the invalid code unit to the runtime parser
+                        result.has_data = false;
+                        return true;
+                    }
+                    fill_size = utf::byte_count(leading_byte);
+                }
+                else if constexpr(sizeof(CharT) == 2)
+                {
+                    if(utf::is_high_surrogate(static_cast<std::uint16_t>(spec[0])))
+                        fill_size = 2;
+                }
+
+                if(fill_size < n && is_align_ch(spec[fill_size]))
+                {
+                    result.fill_size = static_cast<std::uint8_t>(fill_size);
+                    result.align = get_align(spec[fill_size]);
+                    pos = fill_size + 1;
+                }
+            }
+
+            if(pos == n)
+                return true;
+            if(is_align_ch(spec[pos]))
+            {
+                result.align = get_align(spec[pos]);
+                ++pos;
+            }
+
+            if(pos == n)
+                return true;
+            switch(spec[pos])
+            {
+            case CharT('+'):
+                result.sign = format_sign::positive;
+                ++pos;
+                break;
+            case CharT('-'):
+                result.sign = format_sign::negative;
+                ++pos;
+                break;
+            case CharT(' '):
+                result.sign = format_sign::space;
+                ++pos;
+                break;
+
+            default:
+                break;
+            }
+
+            if(pos == n)
+                return true;
+            if(spec[pos] == CharT('#'))
+            {
+                result.alternate_form = true;
+                ++pos;
+            }
+
+            if(pos == n)
+                return true;
+            if(spec[pos] == CharT('0'))
+            {
+                result.fill_zero = true;
+                ++pos;
+            }
+
+            if(pos == n)
+                return true;
+            if(is_ascii_digit(spec[pos]))
+            {
+                if(spec[pos] == CharT('0'))
+                    return false;
+
+                std::size_t width = 0;
+                for(; pos < n && is_ascii_digit(spec[pos]); ++pos)
+                {
+                    width = width * 10 + static_cast<std::size_t>(spec[pos] - CharT('0'));
+                    if(width > max_value)
+                        result.has_data = false;
+                }
+                result.width = static_cast<std::uint8_t>(width);
+            }
+
+            if(pos == n)
+                return true;
+            if(spec[pos] == CharT('.'))
+            {
+                ++pos;
+                if(pos == n || !is_ascii_digit(spec[pos]))
+                    return false;
+
+                std::size_t precision = 0;
+                for(; pos < n && is_ascii_digit(spec[pos]); ++pos)
+                {
+                    precision = precision * 10 + static_cast<std::size_t>(spec[pos] - CharT('0'));
+                    if(precision > max_value)
+                        result.has_data = false;
+                }
+                result.precision = static_cast<std::uint8_t>(precision);
+            }
+
+            if(pos == n)
+                return true;
+            if(spec[pos] == CharT('L'))
+            {
+                result.use_locale = true;
+                ++pos;
+            }
 
-                return std::make_pair(flt_val, float_end);
+            if(pos == n)
+                return true;
+            if(const CharT ch = spec[pos]; static_cast<std::make_unsigned_t<CharT>>(ch) < 0x80 &&
+                                           types.find(static_cast<char>(ch)) != types.npos)
+            {
+                result.type = static_cast<char>(ch);
+                ++pos;
             }
             else
             {
-                return std::make_pair(int_val, int_end);
+                return false;
             }
-        }
-
-        my_base::throw_error(script_error_code::invalid_condition, start);
-    }
 
-    static std::pair<bool, iterator> parse_condition(parse_context& ctx, iterator start, iterator stop)
-    {
-        start = my_base::skip_ws(start, stop);
-        if(start == stop) [[unlikely]]
-            my_base::throw_end_of_string();
+            return pos == n;
+        };
 
-        char32_t first_ch = *start;
-        if(first_ch == U'!')
-        {
-            ++start;
-            start = my_base::skip_ws(start, stop);
+        if(!parse())
+            return false;
 
-            auto [var, next_it] = parse_variable(ctx, start, stop);
-            next_it = my_base::skip_ws(next_it, stop);
-            if(next_it == stop) [[unlikely]]
-                my_base::throw_end_of_string();
-            if(*next_it != my_base::condition_end) [[unlikely]]
-                my_base::throw_error(script_error_code::invalid_condition, next_it);
+        out = result;
+        return true;
+    }
 
-            ++next_it;
-            return std::make_pair(!var.template as<bool>(), next_it);
-        }
-        else if(my_base::is_var_start_ch(first_ch))
+    // Checks the explicit argument indices used by a field that will be executed by the interpreter.
+    template <typename CharT, typename CheckIndex>
+    constexpr void check_interpreted_fmt_field(std::basic_string_view<CharT> field, CheckIndex&& check_index)
+    {
+        std::size_t pos = 0;
+        while(pos < field.size())
         {
-            auto [var, next_it] = parse_variable(ctx, start, stop);
-
-            next_it = my_base::skip_ws(next_it, stop);
-            if(next_it == stop) [[unlikely]]
-                my_base::throw_end_of_string();
+            const CharT ch = field[pos];
+            ++pos;
 
-            char32_t ch = *next_it;
-            if(ch == my_base::condition_end)
+            if(ch == CharT('\''))
             {
-                ++next_it;
-                return std::make_pair(var.template as<bool>(), next_it);
+                // Skip the string constant
+                while(pos < field.size())
+                {
+                    const CharT str_ch = field[pos];
+                    ++pos;
+                    if(str_ch == CharT('\\'))
+                        ++pos;
+                    else if(str_ch == CharT('\''))
+                        break;
+                }
             }
-            else if(my_base::is_op_ch(ch))
+            else if(ch == CharT('{') && pos < field.size() && is_ascii_digit(field[pos]))
             {
-                typename my_base::op_id op{};
-                std::tie(op, next_it) = my_base::parse_op(next_it, stop);
-
-                next_it = my_base::skip_ws(next_it, stop);
-
-                auto [var_2, next_it_2] = parse_variable(ctx, next_it, stop);
-                next_it = my_base::skip_ws(next_it_2, stop);
-
-                if(next_it == stop) [[unlikely]]
-                    my_base::throw_end_of_string();
-                if(*next_it != my_base::condition_end) [[unlikely]]
-                    my_base::throw_error(script_error_code::invalid_condition, next_it);
-
-                ++next_it;
-                return std::make_pair(
-                    my_base::execute_op(op, var, var_2),
-                    next_it
-                );
+                std::size_t idx = 0;
+                for(; pos < field.size() && is_ascii_digit(field[pos]); ++pos)
+                    idx = idx * 10 + static_cast<std::size_t>(field[pos] - CharT('0'));
+                check_index(idx);
             }
-
-            my_base::throw_error(script_error_code::invalid_condition, next_it);
         }
-
-        my_base::throw_error(script_error_code::invalid_condition, start);
     }
 
-    static std::pair<format_arg_type, iterator> parse_field_name(
-        parse_context& ctx, iterator start, iterator stop
-    )
+    /**
+     * @brief Parse and check a format string at compile time.
+     *
+     * Errors will be reported by throwing @ref format_error or @ref script_base::error,
+     * which makes the constant evaluation fail.
+     *
+     * @return The segment table. It will be empty if the segments cannot be stored in the table.
+     */
+    template <typename CharT, typename... Args>
+    consteval fmt_segment_buffer<fmt_segment_capacity_v<Args...>> compile_fmt_string(std::basic_string_view<CharT> fmt)
     {
-        if(start == stop) [[unlikely]]
-            my_base::throw_end_of_string();
+        constexpr std::size_t indexed_count = get_indexed_arg_count<Args...>();
+        constexpr std::size_t named_count = get_named_arg_count<Args...>();
 
-        if(char32_t first_ch = *start; utf::is_digit(first_ch))
+        // Categories of indexed arguments
+        constexpr auto categories = []()
         {
-            std::size_t idx = static_cast<std::size_t>(first_ch - U'0');
-            ++start;
+            const fmt_arg_category all[] = {get_fmt_arg_category<Args, CharT>()..., fmt_arg_category::other};
 
-            while(start != stop)
+            std::array<fmt_arg_category, sizeof...(Args) + 1> result{};
+            std::size_t i = 0;
+            for(fmt_arg_category cat : all)
             {
-                char32_t ch = *start;
-                if(!utf::is_digit(ch))
-                    break;
-
-                idx *= 10;
-                idx += static_cast<std::size_t>(ch - U'0');
-                ++start;
+                if(cat != fmt_arg_category::named)
+                    result[i++] = cat;
             }
 
-            ctx.check_arg_id(idx);
-            return std::make_pair(ctx.get_args()[static_cast<ssize_t>(idx)], start);
-        }
-        else if(my_base::is_field_name_ch(first_ch, true))
-        {
-            iterator str_start = start;
-            ++start;
-            iterator str_end = my_base::find_field_name_end(start, stop, false);
-
-            string_ref_type name(str_start, str_end);
+            return result;
+        }();
 
-            return std::make_pair(
-                ctx.get_args().get(string_view_type(name)),
-                str_end
-            );
-        }
-        else if(my_base::is_field_name_end_ch(first_ch)) // use default value
+        // Names and categories of named arguments if all of the names are known at compile time
+        constexpr bool static_names =
+            (true && ... && (!is_named_arg_v<std::remove_cvref_t<Args>> ||
+                             get_static_arg_name<std::remove_cvref_t<Args>, CharT>().data() != nullptr));
+        constexpr auto named_args = []()
         {
-            std::size_t idx = ctx.current_arg_id();
-            ctx.next_arg_id();
-            return std::make_pair(ctx.get_args()[static_cast<ssize_t>(idx)], start);
-        }
+            const std::basic_string_view<CharT> all_names[] = {get_static_arg_name<std::remove_cvref_t<Args>, CharT>()..., {}};
+            const bool all_named[] = {is_named_arg_v<std::remove_cvref_t<Args>>..., false};
+            const fmt_arg_category all_cats[] = {get_named_fmt_arg_category<Args, CharT>()..., fmt_arg_category::other};
 
-        my_base::throw_error(script_error_code::invalid_field_name, start);
-    }
+            std::array<std::pair<std::basic_string_view<CharT>, fmt_arg_category>, named_count + 1> result{};
+            std::size_t i = 0;
+            for(std::size_t j = 0; j < sizeof...(Args); ++j)
+            {
+                if(all_named[j])
+                    result[i++] = std::make_pair(all_names[j], all_cats[j]);
+            }
 
-    static std::pair<format_arg_type, iterator> parse_chained_access(
-        format_arg_type& base_arg, iterator start, iterator stop
-    )
-    {
-        format_arg_type current = base_arg;
+            return result;
+        }();
 
-        while(start != stop)
+        auto check_index = [](std::size_t idx)
         {
-            char32_t first_ch = *start;
-            if(first_ch == U'.')
+            if(idx >= indexed_count)
+                throw format_error("argument index out of range");
+        };
+
+        // The last one wins if a name is used more than once
+        auto find_named_slot = [&](std::basic_string_view<CharT> name) -> std::size_t
+        {
+            for(std::size_t i = named_count; i > 0; --i)
             {
-                ++start;
-                iterator str_start = start;
+                if(named_args[i - 1].first == name)
+                    return i - 1;
+            }
 
-                iterator str_end = my_base::find_field_name_end(start, stop);
+            throw format_error("named argument not found");
+        };
 
-                string_ref_type attr_name(str_start, str_end);
-                if(attr_name.empty())
-                    my_base::throw_error(script_error_code::invalid_attribute, str_end);
+        fmt_segment_buffer<fmt_segment_capacity_v<Args...>> result;
+        bool storable = fmt.size() <= fmt_segment_table::max_fmt_size;
 
-                current = current.attribute(attr_name);
+        std::size_t default_arg_idx = 0;
+        // The default argument index is unknown after dynamic specifications or interpreted fields
+        bool default_arg_known = true;
+        bool manual_indexing = false;
 
-                start = str_end;
-            }
-            else if(first_ch == U'[')
+        parse_fmt_segments<CharT>(
+            fmt,
+            [&](const fmt_segment& seg)
             {
-                ++start;
-                auto [idx, next_it] = my_base::parse_indexing_value(start, stop);
-                if(next_it == stop) [[unlikely]]
-                    my_base::throw_end_of_string();
-                if(*next_it != U']') [[unlikely]]
-                    my_base::throw_error(script_error_code::invalid_index, next_it);
-                ++next_it;
+                fmt_arg_category cat = fmt_arg_category::other;
+                std::size_t named_slot = fmt_segment::no_slot;
 
-                current = current.index(idx);
+                switch(seg.kind)
+                {
+                case fmt_segment_kind::automatic:
+                    if(manual_indexing)
+                        throw format_error("no default argument after an explicit argument");
+                    if(default_arg_known)
+                    {
+                        check_index(default_arg_idx);
+                        cat = categories[default_arg_idx];
+                        ++default_arg_idx;
+                    }
+                    break;
 
-                start = next_it;
-            }
-            else
-            {
-                break;
+                case fmt_segment_kind::indexed:
+                    check_index(seg.arg_id);
+                    cat = categories[seg.arg_id];
+                    manual_indexing = true;
+                    break;
+
+                case fmt_segment_kind::named:
+                    if constexpr(named_count == 0)
+                        throw format_error("named argument not found");
+                    else if constexpr(static_names)
+                    {
+                        named_slot = find_named_slot(fmt.substr(seg.arg_id, seg.name_size));
+                        cat = named_args[named_slot].second;
+                    }
+                    break;
+
+                case fmt_segment_kind::interpreted:
+                    check_interpreted_fmt_field(fmt.substr(seg.offset, seg.size), check_index);
+                    // Replacement field with chained access, e.g. "{0.length}"
+                    if(is_ascii_digit(fmt[seg.offset + 1]))
+                        manual_indexing = true;
+                    default_arg_known = false;
+                    break;
+
+                default:
+                    break;
+                }
+
+                fmt_static_segment static_seg{
+                    .offset = static_cast<std::uint8_t>(seg.offset),
+                    .size = static_cast<std::uint8_t>(seg.size),
+                    .arg_id = static_cast<std::uint8_t>(seg.arg_id),
+                    .name_size = static_cast<std::uint8_t>(seg.name_size),
+                    .kind = seg.kind,
+                    .dynamic_spec = seg.dynamic_spec
+                };
+                if(named_slot < std::numeric_limits<std::uint8_t>::max())
+                    static_seg.named_slot = static_cast<std::uint8_t>(named_slot);
+
+                if(seg.dynamic_spec)
+                {
+                    default_arg_known = false;
+                }
+                else if(seg.kind != fmt_segment_kind::literal &&
+                        seg.kind != fmt_segment_kind::interpreted)
+                {
+                    const bool valid = parse_static_std_spec(
+                        fmt.substr(seg.offset, seg.size),
+                        get_fmt_accepted_types(cat),
+                        static_seg
+                    );
+
+                    if(!valid && cat != fmt_arg_category::other)
+                        throw format_error("invalid format specification");
+                }
+
+                if(result.size() == result.max_size ||
+                   seg.arg_id > std::numeric_limits<std::uint8_t>::max())
+                    storable = false;
+                if(storable)
+                    result.push_back(static_seg);
             }
-        }
+        );
 
-        return std::make_pair(std::move(current), start);
+        if(!storable)
+            result.clear();
+
+        return result;
     }
-};
+} // namespace detail
 
 /// @}
 
@@ -4864,60 +7457,214 @@ protected:
         return m_data;
     }
 
-    const std_formatter_data& data() const noexcept
-    {
-        return m_data;
+    const std_formatter_data& data() const noexcept
+    {
+        return m_data;
+    }
+
+    /**
+     * @brief Returns the left and right size for filling
+     *
+     * @param used Used length
+     * @return std::pair<std::size_t, std::size_t> Left and right size to fill
+     */
+    std::pair<std::size_t, std::size_t> fill_size(std::size_t used) const noexcept
+    {
+        if(m_data.width <= used)
+            return std::make_pair(0, 0);
+
+        std::size_t remain = m_data.width - used;
+        switch(m_data.align)
+        {
+        case format_align::right:
+            return std::make_pair(remain, 0);
+
+        case format_align::left:
+            return std::make_pair(0, remain);
+
+        case format_align::middle:
+            return std::make_pair(
+                remain / 2,
+                remain / 2 + remain % 2 // ceil(remain / 2)
+            );
+
+        default:
+        case format_align::default_align:
+            PAPILIO_UNREACHABLE();
+        }
+    }
+
+    template <typename FormatContext>
+    void fill(FormatContext& ctx, std::size_t count) const
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        PAPILIO_ASSERT(m_data.fill != U'\0');
+        context_t::append(ctx, m_data.fill, count);
+    }
+};
+
+/// @defgroup DigitMap Digit maps for implementing formatters
+/// @{
+
+inline constexpr char digit_map_lower[16] =
+    {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+inline constexpr char digit_map_upper[16] =
+    {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+namespace detail
+{
+    // Two-digit lookup tables. The N-th pair of characters is the digits of N.
+    template <int Base, bool Uppercase = false>
+    inline constexpr auto digit_pairs = []()
+    {
+        const auto& digits = Uppercase ? digit_map_upper : digit_map_lower;
+
+        std::array<char, Base * Base * 2> result{};
+        for(int i = 0; i < Base * Base; ++i)
+        {
+            result[static_cast<std::size_t>(i) * 2] = digits[i / Base];
+            result[static_cast<std::size_t>(i) * 2 + 1] = digits[i % Base];
+        }
+
+        return result;
+    }();
+
+    // Powers of 10 for counting decimal digits. The first element is 0 so that 0 has 1 digit.
+    inline constexpr std::uint64_t dec_digit_thresholds[20] = {
+        0,
+        10u,
+        100u,
+        1000u,
+        10000u,
+        100000u,
+        1000000u,
+        10000000u,
+        100000000u,
+        1000000000u,
+        10000000000u,
+        100000000000u,
+        1000000000000u,
+        10000000000000u,
+        100000000000000u,
+        1000000000000000u,
+        10000000000000000u,
+        100000000000000000u,
+        1000000000000000000u,
+        10000000000000000000u
+    };
+
+    template <std::unsigned_integral UInt>
+    [[nodiscard]]
+    constexpr std::size_t count_digits(UInt val, int base) noexcept
+    {
+        const std::size_t bits = static_cast<std::size_t>(std::bit_width(val));
+        switch(base)
+        {
+        case 2:
+            return bits == 0 ? 1 : bits;
+
+        case 8:
+            return bits == 0 ? 1 : (bits + 2) / 3;
+
+        case 16:
+            return bits == 0 ? 1 : (bits + 3) / 4;
+
+        default:
+            PAPILIO_ASSERT(base == 10);
+            break;
+        }
+
+        if constexpr(sizeof(UInt) <= sizeof(std::uint64_t))
+        {
+            // 1233 / 4096 is an approximation of log10(2)
+            const std::size_t t = (bits * 1233) >> 12;
+            return t + 1 - (static_cast<std::uint64_t>(val) < dec_digit_thresholds[t]);
+        }
+        else
+        {
+            std::size_t count = 1;
+            while(val >= 10)
+            {
+                val /= 10;
+                ++count;
+            }
+
+            return count;
+        }
     }
 
     /**
-     * @brief Returns the left and right size for filling
+     * @brief Write the digits of an unsigned integer in order.
      *
-     * @param used Used length
-     * @return std::pair<std::size_t, std::size_t> Left and right size to fill
+     * @param buf The output buffer, which must be large enough for the digits.
+     * @return std::size_t Number of digits
      */
-    std::pair<std::size_t, std::size_t> fill_size(std::size_t used) const noexcept
+    template <typename CharT, std::unsigned_integral UInt>
+    constexpr std::size_t write_digits(CharT* buf, UInt val, int base, bool uppercase) noexcept
     {
-        if(m_data.width <= used)
-            return std::make_pair(0, 0);
+        const std::size_t count = detail::count_digits(val, base);
+        CharT* p = buf + count;
 
-        std::size_t remain = m_data.width - used;
-        switch(m_data.align)
+        const auto write_pair = [&p](const auto& pairs, std::size_t idx)
         {
-        case format_align::right:
-            return std::make_pair(remain, 0);
+            *--p = static_cast<CharT>(pairs[idx * 2 + 1]);
+            *--p = static_cast<CharT>(pairs[idx * 2]);
+        };
 
-        case format_align::left:
-            return std::make_pair(0, remain);
+        switch(base)
+        {
+        case 10:
+            while(val >= 100)
+            {
+                write_pair(digit_pairs<10>, static_cast<std::size_t>(val % 100));
+                val /= 100;
+            }
+            if(val >= 10)
+                write_pair(digit_pairs<10>, static_cast<std::size_t>(val));
+            else
+                *--p = static_cast<CharT>('0' + static_cast<int>(val));
+            break;
 
-        case format_align::middle:
-            return std::make_pair(
-                remain / 2,
-                remain / 2 + remain % 2 // ceil(remain / 2)
-            );
+        case 16:
+        {
+            const auto& pairs = uppercase ? digit_pairs<16, true> : digit_pairs<16>;
+            while(val >= 256)
+            {
+                write_pair(pairs, static_cast<std::size_t>(val & 0xFF));
+                val >>= 8;
+            }
+            if(val >= 16)
+                write_pair(pairs, static_cast<std::size_t>(val));
+            else
+            {
+                const auto& digits = uppercase ? digit_map_upper : digit_map_lower;
+                *--p = static_cast<CharT>(digits[static_cast<std::size_t>(val)]);
+            }
+        }
+        break;
+
+        case 8:
+        case 2:
+        {
+            const int shift = base == 8 ? 3 : 1;
+            const UInt mask = static_cast<UInt>(base - 1);
+            do
+            {
+                *--p = static_cast<CharT>('0' + static_cast<int>(val & mask));
+                val >>= shift;
+            } while(val != 0);
+        }
+        break;
 
         default:
-        case format_align::default_align:
             PAPILIO_UNREACHABLE();
         }
-    }
 
-    template <typename FormatContext>
-    void fill(FormatContext& ctx, std::size_t count) const
-    {
-        using context_t = format_context_traits<FormatContext>;
-
-        PAPILIO_ASSERT(m_data.fill != U'\0');
-        context_t::append(ctx, m_data.fill, count);
+        PAPILIO_ASSERT(p == buf);
+        return count;
     }
-};
-
-/// @defgroup DigitMap Digit maps for implementing formatters
-/// @{
-
-inline constexpr char digit_map_lower[16] =
-    {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
-inline constexpr char digit_map_upper[16] =
-    {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+} // namespace detail
 
 template <typename CharT>
 inline constexpr std::basic_string_view<CharT> inf_name_lower = PAPILIO_TSTRING_VIEW(CharT, "inf");
@@ -4985,33 +7732,23 @@ public:
             }
         }
 
-        CharT buf[sizeof(T) * 8];
-        std::size_t buf_size = 0;
-
         auto [base, uppercase] = parse_type_ch(data().type);
 
-        const auto& digits = uppercase ? digit_map_upper : digit_map_lower;
-
         const bool neg = val < 0;
 
-        if constexpr(std::is_signed_v<T>)
-        {
-            do
-            {
-                const T digit = std::abs(val % static_cast<T>(base));
-                buf[buf_size++] = static_cast<CharT>(digits[digit]);
-                val /= static_cast<T>(base);
-            } while(val);
-        }
+        // Absolute value. Negating the unsigned value is well-defined for the minimum value.
+        using unsigned_type = std::make_unsigned_t<T>;
+        unsigned_type abs_val = static_cast<unsigned_type>(val);
+        if(neg)
+            abs_val = static_cast<unsigned_type>(unsigned_type(0) - abs_val);
+
+        // The digits are not needed if only the size of result is calculated.
+        CharT buf[sizeof(T) * 8];
+        std::size_t buf_size;
+        if constexpr(context_t::size_only())
+            buf_size = detail::count_digits(abs_val, base);
         else
-        {
-            do
-            {
-                const T digit = val % static_cast<T>(base);
-                buf[buf_size++] = static_cast<CharT>(digits[digit]);
-                val /= static_cast<T>(base);
-            } while(val);
-        }
+            buf_size = detail::write_digits(buf, abs_val, base, uppercase);
 
         std::size_t used = buf_size;
         if(data().alternate_form)
@@ -5089,15 +7826,119 @@ public:
             }
         }
 
-        for(std::size_t i = buf_size; i > 0; --i)
-            context_t::append(ctx, buf[i - 1]);
+        if constexpr(context_t::size_only())
+            context_t::add_count(ctx, buf_size);
+        else
+            context_t::append(ctx, buf, buf + buf_size);
 
         fill(ctx, right);
 
         return context_t::out(ctx);
     }
 
+protected:
+    // Only used by the formatter of T, because a derived formatter may customize the formatting of a single value.
+    friend class formatter<T, CharT>;
+
+    /**
+     * @brief Format integers separated by `sep`.
+     *
+     * The results are written into a buffer on the stack in blocks,
+     * so the output is appended once per block instead of several times per value.
+     *
+     * @return false if the specification has a width or uses locale, which is not supported by this function.
+     */
+    template <typename FormatContext>
+    bool format_range(std::span<const T> vals, std::basic_string_view<CharT> sep, FormatContext& ctx) const
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        // The size is already counted in O(1) by the formatting of a single value
+        if constexpr(context_t::size_only())
+            return false;
+        else
+        {
+            if(data().width != 0)
+                return false;
+            if constexpr(context_t::use_locale())
+            {
+                if(data().use_locale)
+                    return false;
+            }
+
+            // Sign, prefix of alternate form and digits
+            constexpr std::size_t max_value_size = 3 + sizeof(T) * 8;
+            constexpr std::size_t block_size = 512;
+            if(sep.size() > block_size - max_value_size)
+                return false;
+
+            auto [base, uppercase] = parse_type_ch(data().type);
+
+            CharT block[block_size];
+            CharT* p = block;
+            for(std::size_t i = 0; i < vals.size(); ++i)
+            {
+                if(static_cast<std::size_t>(block + block_size - p) < sep.size() + max_value_size)
+                {
+                    context_t::append(ctx, block, p);
+                    if(context_t::exhausted(ctx))
+                        return true;
+                    p = block;
+                }
+
+                if(i != 0)
+                    p = std::copy(sep.begin(), sep.end(), p);
+                p = write_value(p, vals[i], base, uppercase);
+            }
+            context_t::append(ctx, block, p);
+
+            return true;
+        }
+    }
+
 private:
+    // Write the sign, the prefix of alternate form and the digits without fill.
+    CharT* write_value(CharT* p, T val, int base, bool uppercase) const noexcept
+    {
+        const bool neg = val < 0;
+
+        using unsigned_type = std::make_unsigned_t<T>;
+        unsigned_type abs_val = static_cast<unsigned_type>(val);
+        if(neg)
+            abs_val = static_cast<unsigned_type>(unsigned_type(0) - abs_val);
+
+        switch(data().sign)
+        {
+        case format_sign::negative:
+        case format_sign::default_sign:
+            if(neg)
+                *p++ = static_cast<CharT>('-');
+            break;
+
+        case format_sign::positive:
+            *p++ = static_cast<CharT>(neg ? '-' : '+');
+            break;
+
+        case format_sign::space:
+            *p++ = static_cast<CharT>(neg ? '-' : ' ');
+            break;
+
+        default:
+            PAPILIO_UNREACHABLE();
+        }
+
+        if(data().alternate_form && base != 10)
+        {
+            *p++ = static_cast<CharT>('0');
+            if(base == 16)
+                *p++ = static_cast<CharT>(uppercase ? 'X' : 'x');
+            else if(base == 2)
+                *p++ = static_cast<CharT>(uppercase ? 'B' : 'b');
+        }
+
+        return p + detail::write_digits(p, abs_val, base, uppercase);
+    }
+
     // Returns the number base and whether to use uppercase.
     static std::pair<int, bool> parse_type_ch(char32_t ch) noexcept
     {
@@ -5167,7 +8008,7 @@ private:
         using context_t = format_context_traits<Context>;
 
         small_vector<CharT, 256> buf;
-        const facet_type& facet = std::use_facet<facet_type>(context_t::getloc_ref(ctx));
+        const detail::locale_punct<CharT>& punct = detail::get_locale_punct<CharT>(context_t::getloc_ref(ctx).get_ref());
 
         auto [base, uppercase] = parse_type_ch(data().type);
 
@@ -5178,16 +8019,19 @@ private:
         std::size_t used = 0;
         std::size_t digit_count = 0;
 
-        std::string grouping = facet.grouping();
-        CharT sep = facet.thousands_sep();
+        std::string_view grouping = punct.grouping;
+        CharT sep = punct.thousands_sep;
         const std::size_t sep_width = utf::codepoint(static_cast<char32_t>(sep)).estimate_width();
 
         auto write_buf = [&, sep_idx = std::size_t(0), count_since_sep = std::size_t(0)](CharT ch) mutable
         {
             if(digit_count != 0)
             {
+                // Non-positive values and CHAR_MAX mean the group is unlimited
                 char current_grouping_val = PAPILIO_NS index_grouping(grouping, sep_idx);
-                if(count_since_sep >= std::size_t(current_grouping_val))
+                if(current_grouping_val > 0 &&
+                   current_grouping_val != std::numeric_limits<char>::max() &&
+                   count_since_sep >= std::size_t(current_grouping_val))
                 {
                     buf.push_back(sep);
                     used += sep_width;
@@ -5294,8 +8138,8 @@ private:
             }
         }
 
-        for(std::size_t i = buf.size(); i > 0; --i)
-            context_t::append(ctx, buf[i - 1]);
+        std::reverse(buf.begin(), buf.end());
+        context_t::append(ctx, buf.begin(), buf.end());
 
         fill(ctx, right);
 
@@ -5345,86 +8189,223 @@ public:
     {
         using context_t = format_context_traits<FormatContext>;
 
-        small_vector<CharT, 256> buf;
-
-        std::size_t used = 0;
-
         bool neg = std::signbit(val);
         val = std::abs(val);
 
-        bool use_locale = false;
         if constexpr(context_t::use_locale())
         {
             if(data().use_locale)
+                return format_by_facet(val, neg, ctx);
+        }
+
+        if constexpr(direct_output<FormatContext>())
+        {
+            // Without fill, the result can be written into the end of the container
+            if(data().width == 0 && std::isfinite(val))
             {
-                use_locale = true;
-                used += float_to_chars_reversed(
-                            ctx.getloc_ref(), std::back_inserter(buf), val
-                )
-                            .second;
+                if(write_direct(val, neg, detail::get_container(context_t::out(ctx))))
+                    return context_t::out(ctx);
             }
         }
 
-        if(!use_locale)
-            used += float_to_chars(std::back_inserter(buf), val).second;
+        return visit_chars(
+            val,
+            [&](std::string_view chars)
+            {
+                std::size_t used = chars.size();
+                if(has_sign(neg))
+                    ++used;
+
+                auto [left, right] = fill_size(used);
 
-        switch(data().sign)
+                fill(ctx, left);
+                append_sign(ctx, neg);
+                context_t::append(ctx, chars.begin(), chars.end());
+                fill(ctx, right);
+
+                return context_t::out(ctx);
+            }
+        );
+    }
+
+protected:
+    // Only used by the formatter of T, because a derived formatter may customize the formatting of a single value.
+    friend class formatter<T, CharT>;
+
+    /**
+     * @brief Format floating points separated by `sep`.
+     *
+     * The results are converted into a buffer on the stack in blocks,
+     * so the output is appended once per block instead of several times per value.
+     * Values too long for the buffer fall back to the formatting of a single value.
+     *
+     * @return false if the specification has a width or uses locale, which is not supported by this function.
+     */
+    template <typename FormatContext>
+    bool format_range(std::span<const T> vals, std::basic_string_view<CharT> sep, FormatContext& ctx) const
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        if constexpr(!std::same_as<CharT, char>)
+            return false;
+        else
         {
-        case format_sign::default_sign:
-        case format_sign::negative:
-            if(neg)
-                ++used;
-            break;
+            if(data().width != 0)
+                return false;
+            if constexpr(context_t::use_locale())
+            {
+                if(data().use_locale)
+                    return false;
+            }
 
-        case format_sign::positive:
-        case format_sign::space:
-            ++used;
-            break;
+            // Sign and the result of std::to_chars
+            constexpr std::size_t max_value_size = 1 + stack_buf_size;
+            constexpr std::size_t block_size = 1024;
+            if(sep.size() > block_size - max_value_size)
+                return false;
 
-        default:
-            PAPILIO_UNREACHABLE();
+            auto [ch_fmt, uppercase] = get_chars_fmt();
+
+            char block[block_size];
+            char* p = block;
+            for(std::size_t i = 0; i < vals.size(); ++i)
+            {
+                if(static_cast<std::size_t>(block + block_size - p) < sep.size() + max_value_size)
+                {
+                    context_t::append(ctx, block, p);
+                    if(context_t::exhausted(ctx))
+                        return true;
+                    p = block;
+                }
+
+                if(i != 0)
+                    p = std::copy(sep.begin(), sep.end(), p);
+
+                const bool neg = std::signbit(vals[i]);
+                const T val = std::abs(vals[i]);
+                if(has_sign(neg))
+                    *p++ = sign_char(neg);
+
+                std::string_view special;
+                if(std::isinf(val)) [[unlikely]]
+                    special = uppercase ? inf_name_upper<char> : inf_name_lower<char>;
+                else if(std::isnan(val)) [[unlikely]]
+                    special = uppercase ? nan_name_upper<char> : nan_name_lower<char>;
+                if(!special.empty()) [[unlikely]]
+                {
+                    p = std::copy(special.begin(), special.end(), p);
+                    continue;
+                }
+
+                std::to_chars_result result = call_char_conv(val, p, p + stack_buf_size, ch_fmt);
+                if(result.ec != std::errc()) [[unlikely]]
+                {
+                    // The sign is still in the block
+                    context_t::append(ctx, block, p);
+                    p = block;
+                    visit_chars(
+                        val,
+                        [&ctx](std::string_view chars)
+                        { context_t::append(ctx, chars); }
+                    );
+                    continue;
+                }
+
+                if(uppercase)
+                    to_upper(p, result.ptr);
+                p = result.ptr;
+            }
+            context_t::append(ctx, block, p);
+
+            return true;
         }
+    }
 
-        auto [left, right] = fill_size(used);
+private:
+    // Size of the buffer on the stack, which is enough for most values.
+    static constexpr std::size_t stack_buf_size = 128;
 
-        fill(ctx, left);
+    // Check if the output appends to a contiguous and resizable container of char.
+    template <typename FormatContext>
+    static constexpr bool direct_output() noexcept
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        if constexpr(std::same_as<CharT, char> && context_t::bulk_output())
+        {
+            return requires(typename FormatContext::iterator it) {
+                detail::get_container(it).resize(std::size_t());
+                { detail::get_container(it).data() } -> std::same_as<char*>;
+            };
+        }
+        else
+            return false;
+    }
 
+    bool has_sign(bool neg) const noexcept
+    {
         switch(data().sign)
         {
         case format_sign::default_sign:
         case format_sign::negative:
-            if(neg)
-                context_t::append(ctx, static_cast<CharT>('-'));
-            break;
+            return neg;
 
         case format_sign::positive:
-            context_t::append(ctx, static_cast<CharT>(neg ? '-' : '+'));
-            break;
-
         case format_sign::space:
-            context_t::append(ctx, static_cast<CharT>(neg ? '-' : ' '));
-            break;
+            return true;
 
         default:
             PAPILIO_UNREACHABLE();
         }
+    }
+
+    char sign_char(bool neg) const noexcept
+    {
+        if(neg)
+            return '-';
+        return data().sign == format_sign::space ? ' ' : '+';
+    }
+
+    template <typename FormatContext>
+    void append_sign(FormatContext& ctx, bool neg) const
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        if(has_sign(neg))
+            context_t::append(ctx, static_cast<CharT>(sign_char(neg)));
+    }
+
+    // Write the result into the end of the container without intermediate buffer.
+    // Returns false if the result is too long for this path.
+    template <typename Container>
+    bool write_direct(T val, bool neg, Container& c) const
+    {
+        auto [ch_fmt, uppercase] = get_chars_fmt();
+
+        const bool sign = has_sign(neg);
+        const std::size_t old_size = c.size();
+        c.resize(old_size + stack_buf_size);
 
-        if(use_locale)
+        char* const first = c.data() + old_size;
+        if(sign)
+            *first = sign_char(neg);
+
+        std::to_chars_result result = call_char_conv(
+            val, first + sign, c.data() + c.size(), ch_fmt
+        );
+        if(result.ec != std::errc()) [[unlikely]]
         {
-            context_t::advance_to(
-                ctx,
-                std::reverse_copy(buf.begin(), buf.end(), ctx.out())
-            );
+            c.resize(old_size);
+            return false;
         }
-        else
-            context_t::append(ctx, std::basic_string_view<CharT>(buf.data(), buf.size()));
 
-        fill(ctx, right);
+        if(uppercase)
+            to_upper(first + sign, result.ptr);
+        c.resize(static_cast<std::size_t>(result.ptr - c.data()));
 
-        return context_t::out(ctx);
+        return true;
     }
 
-private:
     std::pair<std::chars_format, bool> get_chars_fmt() const
     {
         std::chars_format ch_fmt{};
@@ -5466,9 +8447,7 @@ private:
         return std::make_pair(ch_fmt, uppercase);
     }
 
-    std::size_t call_char_conv(
-        T val, char* buf, std::size_t buf_size, std::chars_format ch_fmt
-    ) const
+    int get_precision() const noexcept
     {
         const std::u32string_view use_default_precision = U"fFeEgG";
 
@@ -5479,150 +8458,177 @@ private:
             precision = 6;
         }
 
-        std::to_chars_result result;
+        return precision;
+    }
+
+    std::to_chars_result call_char_conv(
+        T val, char* first, char* last, std::chars_format ch_fmt
+    ) const
+    {
+        const int precision = get_precision();
         if(precision == 0)
-            result = std::to_chars(buf, buf + buf_size, val, ch_fmt);
+            return std::to_chars(first, last, val, ch_fmt);
         else
-            result = std::to_chars(buf, buf + buf_size, val, ch_fmt, precision);
+            return std::to_chars(first, last, val, ch_fmt, precision);
+    }
 
-        if(result.ec == std::errc::value_too_large) [[unlikely]]
-        {
-            throw format_error("value too large");
-        }
-        else if(result.ec == std::errc())
+    static void to_upper(char* first, char* last) noexcept
+    {
+        for(; first != last; ++first)
         {
-            return static_cast<std::size_t>(result.ptr - buf);
+            if('a' <= *first && *first <= 'z')
+                *first -= 'a' - 'A';
         }
-
-        PAPILIO_UNREACHABLE();
     }
 
-    template <typename OutputIt>
-    std::pair<OutputIt, std::size_t> float_to_chars(OutputIt out, T val) const
+    // Convert the value to characters and pass them to the callback.
+    // Large values of fixed format and high precision are converted with a dynamic allocated buffer.
+    template <typename Callback>
+    decltype(auto) visit_chars(T val, Callback&& cb) const
     {
-        using namespace std::literals;
-
         auto [ch_fmt, uppercase] = get_chars_fmt();
 
         if(std::isinf(val)) [[unlikely]]
-        {
-            auto inf_name = uppercase ? inf_name_upper<char> : inf_name_lower<char>;
-            out = std::copy(inf_name.begin(), inf_name.end(), out);
-            return {std::move(out), 3};
-        }
+            return cb(uppercase ? inf_name_upper<char> : inf_name_lower<char>);
         else if(std::isnan(val)) [[unlikely]]
-        {
-            auto nan_name = uppercase ? nan_name_upper<char> : nan_name_lower<char>;
-            out = std::copy(nan_name.begin(), nan_name.end(), out);
-            return {std::move(out), 3};
-        }
+            return cb(uppercase ? nan_name_upper<char> : nan_name_lower<char>);
 
-        char buf[256];
-        std::size_t size = call_char_conv(val, buf, std::size(buf), ch_fmt);
+        char buf[stack_buf_size];
+        std::to_chars_result result = call_char_conv(val, buf, buf + stack_buf_size, ch_fmt);
+        if(result.ec == std::errc()) [[likely]]
+        {
+            if(uppercase)
+                to_upper(buf, result.ptr);
+            return cb(std::string_view(buf, result.ptr));
+        }
+
+        // Upper bound of the result: all digits of the integral and fractional parts,
+        // the precision, the sign, the decimal point and the exponent.
+        using limits = std::numeric_limits<T>;
+        const std::size_t max_size =
+            static_cast<std::size_t>(limits::max_exponent10) +
+            static_cast<std::size_t>(-limits::min_exponent10) +
+            static_cast<std::size_t>(limits::max_digits10) +
+            static_cast<std::size_t>(get_precision()) +
+            32;
+
+        std::string dyn_buf(max_size, '\0');
+        result = call_char_conv(val, dyn_buf.data(), dyn_buf.data() + dyn_buf.size(), ch_fmt);
+        if(result.ec != std::errc()) [[unlikely]]
+            throw format_error("value too large");
 
         if(uppercase)
-        {
-            out = std::transform(
-                buf,
-                buf + size,
-                out,
-                [](char ch) -> CharT
-                {
-                    if('a' <= ch && ch <= 'z')
-                        ch -= 'a' - 'A'; // to upper
-                    return static_cast<CharT>(ch);
-                }
-            );
-        }
-        else
-        {
-            out = std::copy_n(buf, size, out);
-        }
+            to_upper(dyn_buf.data(), result.ptr);
+        return cb(std::string_view(dyn_buf.data(), result.ptr));
+    }
+
+    template <typename FormatContext>
+    auto format_by_facet(T val, bool neg, FormatContext& ctx) const
+        -> typename FormatContext::iterator
+    {
+        using context_t = format_context_traits<FormatContext>;
+
+        small_vector<CharT, 256> buf;
+        const std::size_t length = float_to_chars_reversed(
+                                       context_t::getloc_ref(ctx), std::back_inserter(buf), val
+        )
+                                       .second;
+
+        std::size_t used = length;
+        if(has_sign(neg))
+            ++used;
+
+        auto [left, right] = fill_size(used);
+
+        fill(ctx, left);
+        append_sign(ctx, neg);
+        context_t::advance_to(
+            ctx,
+            std::reverse_copy(buf.begin(), buf.end(), context_t::out(ctx))
+        );
+        fill(ctx, right);
 
-        return {std::move(out), size};
+        return context_t::out(ctx);
     }
 
     // Output in reversed order for easier implementation of locale support
     template <typename OutputIt>
     std::pair<OutputIt, std::size_t> float_to_chars_reversed(locale_ref loc, OutputIt out, T val) const
     {
-        using namespace std::literals;
-
-        auto [ch_fmt, uppercase] = get_chars_fmt();
-
-        if(std::isinf(val)) [[unlikely]]
-        {
-            auto inf_name = uppercase ? inf_name_upper<char> : inf_name_lower<char>;
-            out = std::copy(inf_name.begin(), inf_name.end(), out);
-            return {std::move(out), 3};
-        }
-        else if(std::isnan(val)) [[unlikely]]
+        if(!std::isfinite(val)) [[unlikely]]
         {
-            auto nan_name = uppercase ? nan_name_upper<char> : nan_name_lower<char>;
-            out = std::copy(nan_name.begin(), nan_name.end(), out);
-            return {std::move(out), 3};
+            return visit_chars(
+                val,
+                [&out](std::string_view chars) -> std::pair<OutputIt, std::size_t>
+                {
+                    out = std::reverse_copy(chars.begin(), chars.end(), out);
+                    return {std::move(out), chars.size()};
+                }
+            );
         }
 
-        const facet_type& facet = std::use_facet<facet_type>(loc);
-
-        char buf[256];
-        std::size_t size = call_char_conv(val, buf, std::size(buf), ch_fmt);
-        std::size_t length = 0;
+        const detail::locale_punct<CharT>& punct = detail::get_locale_punct<CharT>(loc.get_ref());
 
-        CharT sep = facet.thousands_sep();
+        CharT sep = punct.thousands_sep;
         const std::size_t sep_width = utf::codepoint(static_cast<char32_t>(sep)).estimate_width();
-        std::string grouping = facet.grouping();
+        std::string_view grouping = punct.grouping;
 
-        std::size_t digit_count = 0;
-        std::size_t sep_idx = 0;
-        std::size_t count_since_sep = 0;
-        bool point_reached = false;
+        return visit_chars(
+            val,
+            [&](std::string_view chars) -> std::pair<OutputIt, std::size_t>
+            {
+                std::size_t length = 0;
 
-        for(auto it = std::reverse_iterator(buf + size); it != std::reverse_iterator(buf); ++it)
-        {
-            char ch = *it;
+                std::size_t digit_count = 0;
+                std::size_t sep_idx = 0;
+                std::size_t count_since_sep = 0;
+                bool point_reached = false;
 
-            if(ch == '.') [[unlikely]]
-            {
-                CharT dp = facet.decimal_point();
-                length += utf::codepoint(static_cast<char32_t>(dp)).estimate_width();
-                point_reached = true;
-                count_since_sep = 0;
+                for(auto it = chars.rbegin(); it != chars.rend(); ++it)
+                {
+                    char ch = *it;
 
-                *out = dp;
-                ++out;
+                    if(ch == '.') [[unlikely]]
+                    {
+                        CharT dp = punct.decimal_point;
+                        length += utf::codepoint(static_cast<char32_t>(dp)).estimate_width();
+                        point_reached = true;
+                        count_since_sep = 0;
 
-                continue;
-            }
+                        *out = dp;
+                        ++out;
 
-            if(digit_count != 0 && point_reached)
-            {
-                char current_grouping_val = index_grouping(grouping, sep_idx);
-                if(count_since_sep >= std::size_t(current_grouping_val))
-                {
-                    ++sep_idx;
-                    count_since_sep = 0;
-                    length += sep_width;
+                        continue;
+                    }
+
+                    if(digit_count != 0 && point_reached)
+                    {
+                        // Non-positive values and CHAR_MAX mean the group is unlimited
+                        char current_grouping_val = index_grouping(grouping, sep_idx);
+                        if(current_grouping_val > 0 &&
+                           current_grouping_val != std::numeric_limits<char>::max() &&
+                           count_since_sep >= std::size_t(current_grouping_val))
+                        {
+                            ++sep_idx;
+                            count_since_sep = 0;
+                            length += sep_width;
+
+                            *out = sep;
+                            ++out;
+                        }
+                    }
 
-                    *out = sep;
+                    ++length;
+                    ++count_since_sep;
+                    ++digit_count;
+
+                    *out = static_cast<CharT>(ch);
                     ++out;
                 }
-            }
 
-            if(uppercase)
-            {
-                if('a' <= ch && ch <= 'z')
-                    ch -= 'a' - 'A'; // to upper
+                return {std::move(out), length};
             }
-            ++length;
-            ++count_since_sep;
-            ++digit_count;
-
-            *out = static_cast<CharT>(ch);
-            ++out;
-        }
-
-        return {std::move(out), length};
+        );
     }
 };
 
@@ -5727,6 +8733,13 @@ public:
             return context_t::out(ctx);
         }
 
+        // Neither width nor precision is set, the width of the string is not needed.
+        if(data().width == 0 && data().precision == 0)
+        {
+            context_t::append(ctx, str);
+            return context_t::out(ctx);
+        }
+
         std::size_t used = 0; // Used width
 
         // The "precision" for a string means the max width can be used.
@@ -5745,8 +8758,8 @@ public:
         }
         else
         {
-            for(utf::codepoint cp : str)
-                used += cp.estimate_width();
+            // Only check if the string is wider than the field instead of measuring the whole string.
+            used = utf::estimate_width(str.to_string_view(), data().width);
         }
 
         auto [left, right] = fill_size(used);
@@ -5811,29 +8824,22 @@ public:
 #ifdef PAPILIO_HAS_ENUM_NAME
         else
         {
-            string_formatter<CharT> fmt;
-            fmt.set_data(m_data);
-            if constexpr(char8_like<CharT>)
-            {
-                std::string_view name = enum_name<Enum>(e);
-                auto name_conv = std::basic_string_view<CharT>(
-                    std::bit_cast<const CharT*>(name.data()),
-                    name.size()
-                );
-                return fmt.format(
-                    name_conv,
-                    ctx
-                );
-            }
-            else
+            if(std::string_view name = enum_name<Enum>(e); !name.empty())
+                return format_name(name, ctx);
+
+            if constexpr(enable_enum_flags<Enum>)
             {
-                utf::string_ref name = enum_name<Enum>(e);
-                auto name_conv = name.to_string<CharT>();
-                return fmt.format(
-                    name_conv,
-                    ctx
-                );
+                std::string name = enum_flags_name<Enum>(e);
+                if(!name.empty())
+                    return format_name(name, ctx);
             }
+
+            // No name for the value, fallback to integer representation
+            std_formatter_data dt = m_data;
+            dt.type = U'd';
+            int_formatter<std::underlying_type_t<Enum>, CharT> fmt;
+            fmt.set_data(dt);
+            return fmt.format(PAPILIO_NS to_underlying(e), ctx);
         }
 #else
         PAPILIO_UNREACHABLE();
@@ -5842,6 +8848,34 @@ public:
 
 private:
     std_formatter_data m_data{.type = U's'};
+
+    template <typename FormatContext>
+    auto format_name(std::string_view name, FormatContext& ctx) const
+        -> typename FormatContext::iterator
+    {
+        string_formatter<CharT> fmt;
+        fmt.set_data(m_data);
+        if constexpr(char8_like<CharT>)
+        {
+            auto name_conv = std::basic_string_view<CharT>(
+                std::bit_cast<const CharT*>(name.data()),
+                name.size()
+            );
+            return fmt.format(
+                name_conv,
+                ctx
+            );
+        }
+        else
+        {
+            utf::string_ref name_ref = name;
+            auto name_conv = name_ref.to_string<CharT>();
+            return fmt.format(
+                name_conv,
+                ctx
+            );
+        }
+    }
 };
 
 /**
@@ -5979,9 +9013,25 @@ end_parse:
 #    pragma clang diagnostic ignored "-Wsign-conversion"
 #endif
 
+        if constexpr(std::ranges::contiguous_range<const R> &&
+                     std::ranges::sized_range<const R> &&
+                     std::same_as<std::ranges::range_value_t<const R>, underlying_type> &&
+                     fmt_t::template has_format_range<underlying_type, FormatContext>())
+        {
+            const std::span<const underlying_type> vals(std::ranges::data(rng), std::ranges::size(rng));
+            if(fmt_t::try_format_range(underlying_fmt, vals, m_sep, fmt_ctx))
+            {
+                context_t::append(fmt_ctx, m_closing);
+                return context_t::out(fmt_ctx);
+            }
+        }
+
         bool first = true;
         for(auto&& i : rng)
         {
+            if(context_t::exhausted(fmt_ctx))
+                break;
+
             if(!first)
             {
                 context_t::append(fmt_ctx, m_sep);
@@ -6116,6 +9166,17 @@ public:
         }
     }
 
+    template <typename FormatContext>
+    bool format_range(std::span<const T> vals, std::basic_string_view<CharT> sep, FormatContext& ctx) const
+    {
+        if(m_data.type == U'c')
+            return false;
+
+        int_formatter<T, CharT> fmt;
+        fmt.set_data(m_data);
+        return fmt.format_range(vals, sep, ctx);
+    }
+
 private:
     std_formatter_data m_data;
 };
@@ -6157,6 +9218,14 @@ public:
         return fmt.format(val, ctx);
     }
 
+    template <typename FormatContext>
+    bool format_range(std::span<const T> vals, std::basic_string_view<CharT> sep, FormatContext& ctx) const
+    {
+        float_formatter<T, CharT> fmt;
+        fmt.set_data(m_data);
+        return fmt.format_range(vals, sep, ctx);
+    }
+
 private:
     std_formatter_data m_data;
 };
@@ -6323,7 +9392,7 @@ private:
             }
             else
             {
-                const auto& facet = std::use_facet<std::numpunct<CharT>>(loc);
+                const auto& facet = std::use_facet<std::numpunct<CharT>>(loc.get_ref());
                 return val ? facet.truename() : facet.falsename();
             }
         }
@@ -6496,6 +9565,277 @@ class formatter<R, CharT> :
 
 namespace detail
 {
+    /**
+     * @brief Executes the segments of a pre-parsed format string.
+     *
+     * Fields with a pre-parsed standard format specification are formatted by built-in formatters directly.
+     * Other fields are formatted by the formatter of argument or the interpreter.
+     *
+     * @sa fmt_segment
+     */
+    template <typename Context>
+    class fmt_segment_executor
+    {
+    public:
+        using char_type = typename Context::char_type;
+        using string_view_type = std::basic_string_view<char_type>;
+        using string_ref_type = utf::basic_string_ref<char_type>;
+        using parse_context = basic_format_parse_context<Context>;
+        using size_type = std::size_t;
+
+        fmt_segment_executor(string_view_type fmt, parse_context& parse_ctx, Context& fmt_ctx) noexcept
+            : m_fmt(fmt), m_parse_ctx(parse_ctx), m_fmt_ctx(fmt_ctx) {}
+
+        /**
+         * @brief Execute a segment.
+         *
+         * @param seg The segment.
+         * @param data Pre-parsed standard format specification of the field. It can be null.
+         * @return False if the rest of the format string has been executed by the interpreter.
+         */
+        bool exec(const fmt_segment& seg, const std_formatter_data* data)
+        {
+            switch(seg.kind)
+            {
+            case fmt_segment_kind::literal:
+                format_context_traits<Context>::append(m_fmt_ctx, m_fmt.substr(seg.offset, seg.size));
+                return true;
+
+            case fmt_segment_kind::interpreted:
+                return exec_interpreted(seg);
+
+            default:
+                return exec_field(seg, data);
+            }
+        }
+
+        /**
+         * @brief Execute all segments of a table.
+         */
+        void exec(const fmt_segment_table& segments)
+        {
+            for(const fmt_static_segment& s : segments)
+            {
+                const fmt_segment seg{
+                    .kind = s.kind,
+                    .dynamic_spec = s.dynamic_spec,
+                    .offset = s.offset,
+                    .size = s.size,
+                    .arg_id = s.arg_id,
+                    .name_size = s.name_size,
+                    .named_slot = s.named_slot == std::numeric_limits<std::uint8_t>::max() ?
+                                      fmt_segment::no_slot :
+                                      s.named_slot
+                };
+
+                bool keep_going = true;
+                if(s.has_data)
+                {
+                    const std_formatter_data data = to_data(s);
+                    keep_going = exec(seg, &data);
+                }
+                else
+                    keep_going = exec(seg, nullptr);
+
+                if(!keep_going)
+                    break;
+            }
+        }
+
+    private:
+        string_view_type m_fmt;
+        parse_context& m_parse_ctx;
+        Context& m_fmt_ctx;
+
+        std_formatter_data to_data(const fmt_static_segment& s) const
+        {
+            std_formatter_data data;
+            data.width = s.width;
+            data.precision = s.precision;
+            if(s.fill_size != 0)
+                data.fill = utf::decoder<char_type>::to_codepoint(m_fmt.substr(s.offset, s.fill_size)).first;
+            data.type = static_cast<char32_t>(s.type);
+            data.align = s.align;
+            data.sign = s.sign;
+            data.fill_zero = s.fill_zero;
+            data.alternate_form = s.alternate_form;
+            data.use_locale = s.use_locale;
+
+            return data;
+        }
+
+        typename string_ref_type::const_iterator iter_at(size_type offset) const
+        {
+            return string_ref_type(m_fmt.substr(offset)).begin();
+        }
+
+        size_type offset_of(const typename string_ref_type::const_iterator& it) const noexcept
+        {
+            return static_cast<size_type>(it.base() - m_fmt.data());
+        }
+
+        const basic_format_arg<Context>& get_arg(const fmt_segment& seg)
+        {
+            const auto& args = m_parse_ctx.get_args();
+
+            switch(seg.kind)
+            {
+            case fmt_segment_kind::automatic:
+                {
+                    size_type idx = m_parse_ctx.current_arg_id();
+                    m_parse_ctx.next_arg_id();
+                    return args.get(idx);
+                }
+
+            case fmt_segment_kind::indexed:
+                m_parse_ctx.check_arg_id(seg.arg_id);
+                return args.get(seg.arg_id);
+
+            case fmt_segment_kind::named:
+                if(seg.named_slot != fmt_segment::no_slot)
+                {
+                    if(const auto* arg = args.get_named_at(seg.named_slot))
+                        return *arg;
+                }
+                return args.get(m_fmt.substr(seg.arg_id, seg.name_size));
+
+            default:
+                PAPILIO_UNREACHABLE();
+            }
+        }
+
+        bool exec_field(const fmt_segment& seg, const std_formatter_data* data)
+        {
+            const auto& arg = get_arg(seg);
+
+            if(data && format_by_data(arg, *data))
+                return true;
+
+            m_parse_ctx.advance_to(iter_at(seg.offset));
+            arg.format(m_parse_ctx, m_fmt_ctx);
+
+            auto it = m_parse_ctx.begin();
+            if(it == m_parse_ctx.end()) [[unlikely]]
+                throw script_base::make_error(script_error_code::end_of_string);
+            if(*it != U'}') [[unlikely]]
+                throw script_base::make_error(script_error_code::invalid_fmt_spec);
+
+            if(offset_of(it) != seg.offset + seg.size) [[unlikely]]
+            {
+                // The formatter consumed the specification in an unexpected way.
+                // Fall back to the interpreter for the remaining part.
+                ++it;
+                m_parse_ctx.advance_to(it);
+                basic_interpreter<Context>().format(m_parse_ctx, m_fmt_ctx);
+
+                return false;
+            }
+
+            return true;
+        }
+
+        bool exec_interpreted(const fmt_segment& seg)
+        {
+            m_parse_ctx.advance_to(iter_at(seg.offset));
+
+            basic_interpreter<Context> intp;
+            auto intp_ctx = intp.create_context(m_parse_ctx, m_fmt_ctx);
+            intp.run_once(intp_ctx);
+
+            if(offset_of(intp_ctx.input()) != seg.offset + seg.size) [[unlikely]]
+            {
+                intp.run(intp_ctx);
+                return false;
+            }
+
+            return true;
+        }
+
+        // Check if the argument of type T uses the built-in formatter in the context.
+        template <typename T>
+        static constexpr bool use_builtin_formatter() noexcept
+        {
+            using formatter_t = typename Context::template formatter_type<T>;
+            return std::same_as<formatter_t, formatter<T, char_type>>;
+        }
+
+        // Formats the argument by built-in formatters with the pre-parsed data.
+        // Returns false if the argument needs its own formatter.
+        bool format_by_data(const basic_format_arg<Context>& arg, const std_formatter_data& data)
+        {
+            return arg.visit(
+                [&]<typename T>(const T& v) -> bool
+                {
+                    if constexpr(std::integral<T> && !std::same_as<T, bool>)
+                    {
+                        if constexpr(use_builtin_formatter<T>())
+                        {
+                            // Leave the "c" type to the formatter for checking the range of value.
+                            if(!data.contains_type(U"XxBbod"))
+                                return false;
+
+                            int_formatter<T, char_type> fmt;
+                            fmt.set_data(data);
+                            m_fmt_ctx.advance_to(fmt.format(v, m_fmt_ctx));
+                            return true;
+                        }
+                        else
+                            return false;
+                    }
+                    else if constexpr(std::floating_point<T>)
+                    {
+                        if constexpr(use_builtin_formatter<T>())
+                        {
+                            if(!data.contains_type(U"fFgGeEaA"))
+                                return false;
+
+                            float_formatter<T, char_type> fmt;
+                            fmt.set_data(data);
+                            m_fmt_ctx.advance_to(fmt.format(v, m_fmt_ctx));
+                            return true;
+                        }
+                        else
+                            return false;
+                    }
+                    else if constexpr(std::same_as<T, utf::codepoint>)
+                    {
+                        if constexpr(use_builtin_formatter<T>())
+                        {
+                            if(!data.contains_type(U"c?"))
+                                return false;
+
+                            codepoint_formatter fmt;
+                            fmt.set_data(data);
+                            m_fmt_ctx.advance_to(fmt.format(v, m_fmt_ctx));
+                            return true;
+                        }
+                        else
+                            return false;
+                    }
+                    else if constexpr(std::same_as<T, utf::basic_string_container<char_type>>)
+                    {
+                        if constexpr(use_builtin_formatter<T>())
+                        {
+                            if(!data.contains_type(U"s?"))
+                                return false;
+
+                            string_formatter<char_type> fmt;
+                            fmt.set_data(data);
+                            m_fmt_ctx.advance_to(fmt.format(v, m_fmt_ctx));
+                            return true;
+                        }
+                        else
+                            return false;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+            );
+        }
+    };
+
     template <typename CharT, typename OutputIt, typename Context>
     OutputIt vformat_to_impl(
         OutputIt out,
@@ -6514,6 +9854,26 @@ namespace detail
 
         return fmt_ctx.out();
     }
+
+    template <typename CharT, typename OutputIt, typename Context>
+    OutputIt vformat_to_impl(
+        OutputIt out,
+        locale_ref loc,
+        std::basic_string_view<CharT> fmt,
+        const fmt_segment_table& segments,
+        const basic_format_args_ref<Context>& args
+    )
+    {
+        if(segments.empty())
+            return vformat_to_impl<CharT, OutputIt, Context>(std::move(out), loc, fmt, args);
+
+        basic_format_parse_context<Context> parse_ctx(fmt, args);
+        Context fmt_ctx(loc, out, args);
+
+        fmt_segment_executor<Context>(fmt, parse_ctx, fmt_ctx).exec(segments);
+
+        return fmt_ctx.out();
+    }
 } // namespace detail
 
 PAPILIO_EXPORT template <typename OutputIt>
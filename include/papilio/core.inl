@@ -157,37 +157,46 @@ requires streamable<T, CharT>
 template <typename Context>
 auto streamable_formatter<T, CharT>::format(const T& val, Context& ctx) const
 {
-    using os_t = basic_oiterstream<
-        CharT,
-        typename Context::iterator>;
+    using context_t = format_context_traits<Context>;
 
-    const bool use_iter_stream =
-        m_data.align == format_align::default_align &&
-        m_data.width == 0 &&
-        m_data.has_fill();
-
-    if(use_iter_stream)
+    if(m_data.width == 0)
     {
-        os_t os(ctx.out());
+        // Write into the output by chunks
+        auto sink = [&ctx](const CharT* first, const CharT* last)
+        {
+            context_t::append(ctx, first, last);
+        };
+        detail::chunked_streambuf<CharT, decltype(sink)> buf(sink);
+        std::basic_ostream<CharT> os(&buf);
 
         setup_locale(os, ctx);
 
         os << val;
+        buf.flush();
 
-        return os.base();
+        return context_t::out(ctx);
     }
     else
     {
-        std::basic_stringstream<CharT> ss;
+        // The width of result is needed for padding.
+        // Collect the result into a buffer with inline storage first, then pad it.
+        basic_memory_buffer<CharT> result;
+        auto sink = [&result](const CharT* first, const CharT* last)
+        {
+            result.append(std::basic_string_view<CharT>(first, last));
+        };
+        detail::chunked_streambuf<CharT, decltype(sink)> buf(sink);
+        std::basic_ostream<CharT> os(&buf);
 
-        setup_locale(ss, ctx);
+        setup_locale(os, ctx);
 
-        ss << val;
+        os << val;
+        buf.flush();
 
         string_formatter<CharT> fmt;
         fmt.set_data(m_data);
 
-        return fmt.format(std::move(ss).str(), ctx);
+        return fmt.format(result.view(), ctx);
     }
 }
 
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <string>
+#include <stdexcept>
 #include <iterator>
 #include "macros.hpp" // IWYU pragma: export
 #include "detail/prefix.hpp"
@@ -28,6 +29,21 @@ namespace utf
     class basic_string_container;
 } // namespace utf
 
+/**
+ * @brief Base of all format error.
+ *
+ * @ingroup Format
+ */
+PAPILIO_EXPORT class format_error : public std::runtime_error
+{
+public:
+    using runtime_error::runtime_error;
+
+    format_error(const format_error&) = default;
+
+    ~format_error() override;
+};
+
 PAPILIO_EXPORT template <typename CharT>
 class basic_indexing_value;
 
@@ -61,6 +77,9 @@ class formatter;
 PAPILIO_EXPORT template <typename CharT>
 using format_iterator_for = std::back_insert_iterator<std::basic_string<CharT>>;
 
+PAPILIO_EXPORT template <typename CharT, std::size_t InlineSize = 500>
+class basic_memory_buffer;
+
 PAPILIO_EXPORT using format_context = basic_format_context<format_iterator_for<char>, char>;
 PAPILIO_EXPORT using wformat_context = basic_format_context<format_iterator_for<wchar_t>, wchar_t>;
 PAPILIO_EXPORT using format_arg = basic_format_arg<format_context>;
@@ -163,13 +163,32 @@ PAPILIO_EXPORT
 [[nodiscard]]
 std::wstring vformat(const std::locale& loc, std::wstring_view fmt, const wformat_args_ref& args);
 
+namespace detail
+{
+    // Uses the segments parsed at compile time if the table is not empty.
+    std::string vformat_impl(
+        locale_ref loc,
+        std::string_view fmt,
+        const fmt_segment_table& segments,
+        const format_args_ref& args
+    );
+    std::wstring vformat_impl(
+        locale_ref loc,
+        std::wstring_view fmt,
+        const fmt_segment_table& segments,
+        const wformat_args_ref& args
+    );
+} // namespace detail
+
 PAPILIO_EXPORT template <typename OutputIt, typename... Args>
 OutputIt format_to(OutputIt out, format_string<Args...> fmt, Args&&... args)
 {
     using context_type = basic_format_context<OutputIt, char>;
-    return PAPILIO_NS vformat_to(
-        out,
+    return detail::vformat_to_impl<char, OutputIt, context_type>(
+        std::move(out),
+        nullptr,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
     );
 }
@@ -177,16 +196,17 @@ OutputIt format_to(OutputIt out, format_string<Args...> fmt, Args&&... args)
 PAPILIO_EXPORT template <typename OutputIt, typename... Args>
 OutputIt format_to(
     OutputIt out,
-    std::locale& loc,
+    const std::locale& loc,
     format_string<Args...> fmt,
     Args&&... args
 )
 {
     using context_type = basic_format_context<OutputIt, char>;
-    return PAPILIO_NS vformat_to(
-        out,
+    return detail::vformat_to_impl<char, OutputIt, context_type>(
+        std::move(out),
         loc,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
     );
 }
@@ -199,9 +219,11 @@ OutputIt format_to(
 )
 {
     using context_type = basic_format_context<OutputIt, wchar_t>;
-    return PAPILIO_NS vformat_to(
-        out,
+    return detail::vformat_to_impl<wchar_t, OutputIt, context_type>(
+        std::move(out),
+        nullptr,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
     );
 }
@@ -209,16 +231,111 @@ OutputIt format_to(
 PAPILIO_EXPORT template <typename OutputIt, typename... Args>
 OutputIt format_to(
     OutputIt out,
-    std::locale& loc,
+    const std::locale& loc,
     wformat_string<Args...> fmt,
     Args&&... args
 )
 {
     using context_type = basic_format_context<OutputIt, wchar_t>;
-    return PAPILIO_NS vformat_to(
-        out,
+    return detail::vformat_to_impl<wchar_t, OutputIt, context_type>(
+        std::move(out),
         loc,
         fmt.get(),
+        fmt.segments(),
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+/**
+ * @brief Format to the end of a memory buffer.
+ *
+ * @return Appender of the buffer
+ */
+PAPILIO_EXPORT template <std::size_t InlineSize, typename... Args>
+auto format_to(
+    basic_memory_buffer<char, InlineSize>& buf,
+    format_string<Args...> fmt,
+    Args&&... args
+) -> typename basic_memory_buffer<char, InlineSize>::appender
+{
+    using iterator = typename basic_memory_buffer<char, InlineSize>::appender;
+    using context_type = basic_format_context<iterator, char>;
+    return detail::vformat_to_impl<char, iterator, context_type>(
+        buf.out(),
+        nullptr,
+        fmt.get(),
+        fmt.segments(),
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+/**
+ * @brief Format to the end of a memory buffer with a locale.
+ *
+ * @return Appender of the buffer
+ */
+PAPILIO_EXPORT template <std::size_t InlineSize, typename... Args>
+auto format_to(
+    basic_memory_buffer<char, InlineSize>& buf,
+    const std::locale& loc,
+    format_string<Args...> fmt,
+    Args&&... args
+) -> typename basic_memory_buffer<char, InlineSize>::appender
+{
+    using iterator = typename basic_memory_buffer<char, InlineSize>::appender;
+    using context_type = basic_format_context<iterator, char>;
+    return detail::vformat_to_impl<char, iterator, context_type>(
+        buf.out(),
+        loc,
+        fmt.get(),
+        fmt.segments(),
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+/**
+ * @brief Format to the end of a memory buffer.
+ *
+ * @return Appender of the buffer
+ */
+PAPILIO_EXPORT template <std::size_t InlineSize, typename... Args>
+auto format_to(
+    basic_memory_buffer<wchar_t, InlineSize>& buf,
+    wformat_string<Args...> fmt,
+    Args&&... args
+) -> typename basic_memory_buffer<wchar_t, InlineSize>::appender
+{
+    using iterator = typename basic_memory_buffer<wchar_t, InlineSize>::appender;
+    using context_type = basic_format_context<iterator, wchar_t>;
+    return detail::vformat_to_impl<wchar_t, iterator, context_type>(
+        buf.out(),
+        nullptr,
+        fmt.get(),
+        fmt.segments(),
+        PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
+    );
+}
+
+/**
+ * @brief Format to the end of a memory buffer with a locale.
+ *
+ * @return Appender of the buffer
+ */
+PAPILIO_EXPORT template <std::size_t InlineSize, typename... Args>
+auto format_to(
+    basic_memory_buffer<wchar_t, InlineSize>& buf,
+    const std::locale& loc,
+    wformat_string<Args...> fmt,
+    Args&&... args
+) -> typename basic_memory_buffer<wchar_t, InlineSize>::appender
+{
+    using iterator = typename basic_memory_buffer<wchar_t, InlineSize>::appender;
+    using context_type = basic_format_context<iterator, wchar_t>;
+    return detail::vformat_to_impl<wchar_t, iterator, context_type>(
+        buf.out(),
+        loc,
+        fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
     );
 }
@@ -278,6 +395,44 @@ namespace detail
             return *this;
         }
 
+        /**
+         * @brief Get the number of characters that can still be written.
+         */
+        [[nodiscard]]
+        difference_type remaining() const noexcept
+        {
+            return m_max_count - m_counter;
+        }
+
+        /**
+         * @brief Write characters by a single copy. The characters beyond the limit are discarded.
+         */
+        void write(const CharT* ptr, std::size_t count)
+        {
+            const difference_type n = clamp_count(count);
+            if constexpr(std::is_pointer_v<OutputIt> &&
+                         std::same_as<std::remove_cv_t<std::remove_pointer_t<OutputIt>>, CharT>)
+            {
+                std::memcpy(m_out, ptr, static_cast<std::size_t>(n) * sizeof(CharT));
+                m_out += n;
+            }
+            else
+            {
+                m_out = std::copy_n(ptr, n, std::move(m_out));
+            }
+            m_counter += n;
+        }
+
+        /**
+         * @brief Write a character repeatedly. The characters beyond the limit are discarded.
+         */
+        void fill(std::size_t count, CharT ch)
+        {
+            const difference_type n = clamp_count(count);
+            m_out = std::fill_n(std::move(m_out), n, ch);
+            m_counter += n;
+        }
+
         [[nodiscard]]
         format_to_n_result<OutputIt> get_result() const noexcept(std::is_nothrow_copy_constructible_v<OutputIt>)
         {
@@ -298,6 +453,14 @@ namespace detail
         OutputIt m_out;
         difference_type m_max_count;
         difference_type m_counter;
+
+        difference_type clamp_count(std::size_t count) const noexcept
+        {
+            const difference_type rest = remaining();
+            if(count > static_cast<std::size_t>(rest))
+                return rest;
+            return static_cast<difference_type>(count);
+        }
     };
 
     template <typename CharT, typename OutputIt, typename... Args>
@@ -324,8 +487,7 @@ namespace detail
                 intp_ctx,
                 [&intp_ctx]() -> bool
                 {
-                    const iter_t& it = intp_ctx.output_context().out_ref();
-                    return it.get_count() < it.get_max_count();
+                    return intp_ctx.output_context().out_ref().remaining() > 0;
                 }
             );
 
@@ -415,6 +577,14 @@ namespace detail
             return m_counter;
         }
 
+        /**
+         * @brief Count characters without writing them.
+         */
+        constexpr void add_count(std::size_t n) noexcept
+        {
+            m_counter += n;
+        }
+
     protected:
         constexpr void count() noexcept
         {
@@ -470,11 +640,13 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char>>& args
     );
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::wstring_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<wchar_t>>& args
     );
 
@@ -482,6 +654,7 @@ namespace detail
     std::size_t formatted_size_helper(
         locale_ref loc,
         std::basic_string_view<CharT> fmt,
+        const fmt_segment_table& segments,
         Args&&... args
     )
     {
@@ -491,6 +664,7 @@ namespace detail
         return formatted_size_impl(
             loc,
             fmt,
+            segments,
             PAPILIO_NS make_format_args<context_type>(std::forward<Args>(args)...)
         );
     }
@@ -506,6 +680,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<char>(
         nullptr,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -521,6 +696,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<char>(
         loc,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -535,6 +711,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<wchar_t>(
         nullptr,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -550,6 +727,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<wchar_t>(
         loc,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -558,8 +736,8 @@ PAPILIO_EXPORT template <typename... Args>
 [[nodiscard]]
 std::string format(format_string<Args...> fmt, Args&&... args)
 {
-    return PAPILIO_NS vformat(
-        fmt.get(), PAPILIO_NS make_format_args(std::forward<Args>(args)...)
+    return detail::vformat_impl(
+        nullptr, fmt.get(), fmt.segments(), PAPILIO_NS make_format_args(std::forward<Args>(args)...)
     );
 }
 
@@ -567,8 +745,8 @@ PAPILIO_EXPORT template <typename... Args>
 [[nodiscard]]
 std::string format(const std::locale& loc, format_string<Args...> fmt, Args&&... args)
 {
-    return PAPILIO_NS vformat(
-        loc, fmt.get(), PAPILIO_NS make_format_args(std::forward<Args>(args)...)
+    return detail::vformat_impl(
+        loc, fmt.get(), fmt.segments(), PAPILIO_NS make_format_args(std::forward<Args>(args)...)
     );
 }
 
@@ -576,8 +754,8 @@ PAPILIO_EXPORT template <typename... Args>
 [[nodiscard]]
 std::wstring format(wformat_string<Args...> fmt, Args&&... args)
 {
-    return PAPILIO_NS vformat(
-        fmt.get(), PAPILIO_NS make_wformat_args(std::forward<Args>(args)...)
+    return detail::vformat_impl(
+        nullptr, fmt.get(), fmt.segments(), PAPILIO_NS make_wformat_args(std::forward<Args>(args)...)
     );
 }
 
@@ -585,11 +763,405 @@ PAPILIO_EXPORT template <typename... Args>
 [[nodiscard]]
 std::wstring format(const std::locale& loc, wformat_string<Args...> fmt, Args&&... args)
 {
-    return PAPILIO_NS vformat(
-        loc, fmt.get(), PAPILIO_NS make_wformat_args(std::forward<Args>(args)...)
+    return detail::vformat_impl(
+        loc, fmt.get(), fmt.segments(), PAPILIO_NS make_wformat_args(std::forward<Args>(args)...)
     );
 }
 
+
+/**
+ * @brief Arguments captured for formatting at a later time, possibly on another thread.
+ *
+ * Strings, names of named arguments, and trivially copyable custom values are copied
+ * into a single contiguous arena together with the format arguments,
+ * so capturing costs one allocation regardless of the number of arguments.
+ * Custom values that are not trivially copyable are copied by the `independent` constructor of format argument.
+ *
+ * @note The format string is referenced rather than copied. It must outlive the capture.
+ *
+ * @tparam Context Format context whose output iterator is a `std::back_insert_iterator` of string.
+ */
+PAPILIO_EXPORT template <typename Context>
+class basic_format_capture
+{
+public:
+    using char_type = typename Context::char_type;
+    using string_type = std::basic_string<char_type>;
+    using string_view_type = std::basic_string_view<char_type>;
+    using format_arg_type = basic_format_arg<Context>;
+    using size_type = std::size_t;
+
+    static_assert(std::same_as<typename Context::iterator, format_iterator_for<char_type>>);
+
+    template <typename... Args>
+    basic_format_capture(basic_format_string<char_type, std::type_identity_t<Args>...> fmt, Args&&... args)
+        : m_fmt(fmt.get())
+    {
+        constexpr size_type indexed_count = detail::get_indexed_arg_count<Args...>();
+        constexpr size_type named_count = detail::get_named_arg_count<Args...>();
+
+        const detail::fmt_segment_table segments = fmt.segments();
+        const size_type total = named_offset(indexed_count) +
+                                named_count * sizeof(named_entry) +
+                                segments.size() * sizeof(segment_type) + alignof(segment_type) - 1 +
+                                (size_type(0) + ... + data_size(args));
+        m_arena.reset(new std::byte[total]);
+
+        ::new(static_cast<void*>(m_arena.get())) header{indexed_count};
+        std::byte* data = m_arena.get() + named_offset(indexed_count) + named_count * sizeof(named_entry);
+        m_segments = copy_segments(data, segments);
+        (emplace(data, std::forward<Args>(args)), ...);
+    }
+
+    basic_format_capture(const basic_format_capture&) = delete;
+    basic_format_capture(basic_format_capture&&) noexcept = default;
+
+    basic_format_capture& operator=(const basic_format_capture&) = delete;
+    basic_format_capture& operator=(basic_format_capture&&) noexcept = default;
+
+    /**
+     * @brief Get the referenced format string.
+     */
+    [[nodiscard]]
+    string_view_type get() const noexcept
+    {
+        return m_fmt;
+    }
+
+    [[nodiscard]]
+    size_type indexed_size() const noexcept
+    {
+        return m_arena ? get_header().indexed_size : 0;
+    }
+
+    [[nodiscard]]
+    size_type named_size() const noexcept
+    {
+        return m_arena ? get_header().named_size : 0;
+    }
+
+    /**
+     * @brief Format the captured arguments.
+     */
+    [[nodiscard]]
+    string_type format() const
+    {
+        string_type result;
+        format_to(std::back_inserter(result));
+        return result;
+    }
+
+    [[nodiscard]]
+    string_type format(const std::locale& loc) const
+    {
+        string_type result;
+        format_to(std::back_inserter(result), loc);
+        return result;
+    }
+
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
+    {
+        return format_to_impl(std::move(out), nullptr);
+    }
+
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out, const std::locale& loc) const
+    {
+        return format_to_impl(std::move(out), loc);
+    }
+
+private:
+    template <typename OutputIt>
+    OutputIt format_to_impl(OutputIt out, locale_ref loc) const
+    {
+        using iterator = typename Context::iterator;
+
+        if constexpr(std::same_as<OutputIt, iterator>)
+        {
+            // The segments were kept in the arena of a moved-from capture
+            if(!m_arena)
+            {
+                return detail::vformat_to_impl<char_type, iterator, Context>(
+                    std::move(out), loc, m_fmt, detail::fmt_segment_table(), empty_format_args_for<Context>()
+                );
+            }
+
+            return detail::vformat_to_impl<char_type, iterator, Context>(
+                std::move(out), loc, m_fmt, m_segments, captured_args(*this)
+            );
+        }
+        else
+        {
+            string_type buf;
+            format_to_impl(std::back_inserter(buf), loc);
+            return std::copy(buf.begin(), buf.end(), std::move(out));
+        }
+    }
+
+    struct named_entry
+    {
+        string_view_type name;
+        format_arg_type value;
+    };
+
+    struct header
+    {
+        size_type indexed_capacity;
+        // Numbers of constructed arguments, which are also used for destroying them
+        size_type indexed_size = 0;
+        size_type named_size = 0;
+    };
+
+    static_assert(alignof(header) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    static_assert(alignof(format_arg_type) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    static_assert(alignof(named_entry) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    static constexpr size_type align_up(size_type n, size_type align) noexcept
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    static constexpr size_type indexed_offset() noexcept
+    {
+        return align_up(sizeof(header), alignof(format_arg_type));
+    }
+
+    static constexpr size_type named_offset(size_type indexed_count) noexcept
+    {
+        return align_up(indexed_offset() + indexed_count * sizeof(format_arg_type), alignof(named_entry));
+    }
+
+    class arena_deleter
+    {
+    public:
+        void operator()(std::byte* mem) const noexcept
+        {
+            header& h = *std::launder(reinterpret_cast<header*>(mem));
+
+            format_arg_type* indexed = std::launder(reinterpret_cast<format_arg_type*>(mem + indexed_offset()));
+            std::destroy_n(indexed, h.indexed_size);
+            named_entry* named = std::launder(reinterpret_cast<named_entry*>(mem + named_offset(h.indexed_capacity)));
+            std::destroy_n(named, h.named_size);
+
+            delete[] mem;
+        }
+    };
+
+    // Views the arguments stored in the arena
+    class captured_args final : public format_args_base<Context, char_type>
+    {
+    public:
+        captured_args(const basic_format_capture& cap) noexcept
+            : m_header(cap.get_header()),
+              m_indexed(cap.indexed_args()),
+              m_named(cap.named_args()) {}
+
+        const format_arg_type& get(size_type i) const override
+        {
+            if(i >= m_header.indexed_size)
+                this->throw_index_out_of_range();
+            return m_indexed[i];
+        }
+
+        const format_arg_type& get(string_view_type key) const override
+        {
+            const named_entry* entry = find(key);
+            if(!entry)
+                this->throw_invalid_named_argument();
+            return entry->value;
+        }
+
+        using format_args_base<Context, char_type>::get;
+
+        bool contains(string_view_type key) const noexcept override
+        {
+            return find(key) != nullptr;
+        }
+
+        using format_args_base<Context, char_type>::contains;
+
+        size_type indexed_size() const noexcept override
+        {
+            return m_header.indexed_size;
+        }
+
+        size_type named_size() const noexcept override
+        {
+            return m_header.named_size;
+        }
+
+        const format_arg_type* get_named_at(size_type slot) const noexcept override
+        {
+            if(slot >= m_header.named_size)
+                return nullptr;
+            return &m_named[slot].value;
+        }
+
+    private:
+        const header& m_header;
+        const format_arg_type* m_indexed;
+        const named_entry* m_named;
+
+        // The last one wins if a name is captured more than once, same as static_format_args
+        const named_entry* find(string_view_type key) const noexcept
+        {
+            for(size_type i = m_header.named_size; i > 0; --i)
+            {
+                if(m_named[i - 1].name == key)
+                    return m_named + (i - 1);
+            }
+
+            return nullptr;
+        }
+    };
+
+    string_view_type m_fmt;
+    detail::fmt_segment_table m_segments;
+    std::unique_ptr<std::byte[], arena_deleter> m_arena;
+
+    header& get_header() const noexcept
+    {
+        return *std::launder(reinterpret_cast<header*>(m_arena.get()));
+    }
+
+    const format_arg_type* indexed_args() const noexcept
+    {
+        return std::launder(reinterpret_cast<const format_arg_type*>(m_arena.get() + indexed_offset()));
+    }
+
+    const named_entry* named_args() const noexcept
+    {
+        return std::launder(reinterpret_cast<const named_entry*>(
+            m_arena.get() + named_offset(get_header().indexed_capacity)
+        ));
+    }
+
+    template <typename T>
+    static constexpr bool copy_to_arena_v =
+        (detail::use_handle<T, char_type> || std::is_bounded_array_v<T>) &&
+        std::is_trivially_copyable_v<T> &&
+        alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    // Bytes needed by the argument in the data area, including padding for alignment
+    template <typename T>
+    static size_type data_size(const T& arg) noexcept
+    {
+        if constexpr(is_named_arg_v<T>)
+        {
+            return arg.name.size() * sizeof(char_type) + alignof(char_type) - 1 +
+                   data_size(arg.get());
+        }
+        else if constexpr(basic_string_like<T, char_type>)
+        {
+            return string_view_type(arg).size() * sizeof(char_type) + alignof(char_type) - 1;
+        }
+        else if constexpr(copy_to_arena_v<T>)
+        {
+            return sizeof(T) + alignof(T) - 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    static std::byte* allocate(std::byte*& data, size_type size, size_type align) noexcept
+    {
+        const auto addr = reinterpret_cast<std::uintptr_t>(data);
+        std::byte* result = data + (align_up(addr, align) - addr);
+        data = result + size;
+        return result;
+    }
+
+    using segment_type = detail::fmt_static_segment;
+
+    static_assert(std::is_trivially_copyable_v<segment_type>);
+
+    // The segments of the format string are kept in the arena, so the view stays valid after moving the capture.
+    static detail::fmt_segment_table copy_segments(std::byte*& data, detail::fmt_segment_table segments) noexcept
+    {
+        if(segments.empty())
+            return detail::fmt_segment_table();
+
+        segment_type* mem = reinterpret_cast<segment_type*>(
+            allocate(data, segments.size() * sizeof(segment_type), alignof(segment_type))
+        );
+        std::uninitialized_copy(segments.begin(), segments.end(), mem);
+        return detail::fmt_segment_table(mem, segments.size());
+    }
+
+    static string_view_type copy_string(std::byte*& data, string_view_type str) noexcept
+    {
+        char_type* mem = reinterpret_cast<char_type*>(
+            allocate(data, str.size() * sizeof(char_type), alignof(char_type))
+        );
+        std::copy_n(str.data(), str.size(), mem);
+        return string_view_type(mem, str.size());
+    }
+
+    template <typename T>
+    static format_arg_type make_arg(std::byte*& data, T&& arg)
+    {
+        using value_type = std::remove_cvref_t<T>;
+
+        if constexpr(basic_string_like<value_type, char_type>)
+        {
+            return format_arg_type(copy_string(data, string_view_type(arg)));
+        }
+        else if constexpr(copy_to_arena_v<value_type>)
+        {
+            std::byte* mem = allocate(data, sizeof(value_type), alignof(value_type));
+            std::memcpy(mem, std::addressof(arg), sizeof(value_type));
+            return format_arg_type(std::as_const(*std::launder(reinterpret_cast<value_type*>(mem))));
+        }
+        else if constexpr(detail::use_handle<value_type, char_type> &&
+                          !std::same_as<value_type, std::type_info>)
+        {
+            return format_arg_type(independent, std::forward<T>(arg));
+        }
+        else
+        {
+            static_assert(
+                !std::is_bounded_array_v<value_type>,
+                "captured arrays must be trivially copyable"
+            );
+            return format_arg_type(std::forward<T>(arg));
+        }
+    }
+
+    template <typename T>
+    void emplace(std::byte*& data, T&& arg)
+    {
+        header& h = get_header();
+
+        if constexpr(is_named_arg_v<std::remove_cvref_t<T>>)
+        {
+            static_assert(
+                std::same_as<char_type, typename std::remove_cvref_t<T>::char_type>,
+                "Invalid char type"
+            );
+
+            std::byte* mem = m_arena.get() +
+                             named_offset(h.indexed_capacity) +
+                             h.named_size * sizeof(named_entry);
+            const string_view_type name = copy_string(data, arg.name);
+            ::new(static_cast<void*>(mem)) named_entry{name, make_arg(data, arg.get())};
+            ++h.named_size;
+        }
+        else
+        {
+            std::byte* mem = m_arena.get() +
+                             indexed_offset() +
+                             h.indexed_size * sizeof(format_arg_type);
+            ::new(static_cast<void*>(mem)) format_arg_type(make_arg(data, std::forward<T>(arg)));
+            ++h.indexed_size;
+        }
+    }
+};
+
+PAPILIO_EXPORT using format_capture = basic_format_capture<format_context>;
+PAPILIO_EXPORT using wformat_capture = basic_format_capture<wformat_context>;
 /// @}
 
 /// @addtogroup Formatter
@@ -612,6 +1184,7 @@ public:
     requires formattable_with<value_type, FormatContext>
     auto format(const joiner_t& j, ParseContext& parse_ctx, FormatContext& fmt_ctx) const
     {
+        using context_t = format_context_traits<FormatContext>;
         using formatter_t = typename FormatContext::template formatter_type<value_type>;
 
         if constexpr(formatter_traits<formatter_t>::template parsable<FormatContext>())
@@ -622,6 +1195,8 @@ public:
             bool first = true;
             for(auto&& i : j)
             {
+                if(context_t::exhausted(fmt_ctx))
+                    break;
                 if(!first)
                     append_sep(fmt_ctx, j);
                 first = false;
@@ -636,6 +1211,8 @@ public:
             bool first = true;
             for(auto&& i : j)
             {
+                if(context_t::exhausted(fmt_ctx))
+                    break;
                 if(!first)
                     append_sep(fmt_ctx, j);
                 first = false;
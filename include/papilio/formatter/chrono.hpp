@@ -7,6 +7,9 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <string>
+#include <optional>
 #include "../format.hpp"
 #include "../chrono/chrono_utility.hpp"
 #include "../chrono/chrono_traits.hpp"
@@ -299,6 +302,341 @@ public:
     }
 };
 
+namespace detail
+{
+    /**
+     * @brief Checks if a chrono specification only contains numeric specifiers,
+     * which can be written without a stream or a locale.
+     *
+     * Accepted specifiers are `%Y %y %m %d %e %j %H %M %S %F %T %R %D %n %t %%`,
+     * and `%z` if `allow_tz` is `true`.
+     */
+    template <typename CharT>
+    constexpr bool is_fast_chrono_spec(std::basic_string_view<CharT> spec, bool allow_tz) noexcept
+    {
+        for(std::size_t i = 0; i < spec.size(); ++i)
+        {
+            if(spec[i] != CharT('%'))
+                continue;
+
+            ++i;
+            if(i == spec.size())
+                return false;
+
+            switch(spec[i])
+            {
+            case CharT('Y'):
+            case CharT('y'):
+            case CharT('m'):
+            case CharT('d'):
+            case CharT('e'):
+            case CharT('j'):
+            case CharT('H'):
+            case CharT('M'):
+            case CharT('S'):
+            case CharT('F'):
+            case CharT('T'):
+            case CharT('R'):
+            case CharT('D'):
+            case CharT('n'):
+            case CharT('t'):
+            case CharT('%'):
+                continue;
+
+            case CharT('z'):
+                if(allow_tz)
+                    continue;
+                return false;
+
+            default:
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Counts %S and %T, which are the specifiers followed by subseconds.
+    template <typename CharT>
+    constexpr std::size_t count_seconds_spec(std::basic_string_view<CharT> spec) noexcept
+    {
+        std::size_t result = 0;
+        for(std::size_t i = 0; i < spec.size(); ++i)
+        {
+            if(spec[i] != CharT('%'))
+                continue;
+
+            ++i;
+            if(i == spec.size())
+                break;
+            if(spec[i] == CharT('S') || spec[i] == CharT('T'))
+                ++result;
+        }
+
+        return result;
+    }
+
+    // Writes exactly `width` digits, `val` must be less than 10^width.
+    template <typename CharT, typename OutputIt>
+    OutputIt put_fixed_digits(OutputIt out, std::uint64_t val, std::size_t width)
+    {
+        CharT buf[20];
+        PAPILIO_ASSERT(width <= std::size(buf));
+
+        for(std::size_t i = width; i > 0; --i)
+        {
+            buf[i - 1] = static_cast<CharT>('0' + val % 10);
+            val /= 10;
+        }
+
+        return std::copy_n(buf, width, std::move(out));
+    }
+
+    // Same as "{:02d}", or "{:2d}" if the fill is a space.
+    template <typename CharT, typename OutputIt>
+    OutputIt put_2digits(OutputIt out, int val, CharT fill = CharT('0'))
+    {
+        if(val < 0 || val > 99) [[unlikely]]
+        {
+            return PAPILIO_NS format_to(
+                std::move(out),
+                fill == CharT('0') ?
+                    PAPILIO_TSTRING_VIEW(CharT, "{:02d}") :
+                    PAPILIO_TSTRING_VIEW(CharT, "{:2d}"),
+                val
+            );
+        }
+
+        *out = val < 10 ? fill : static_cast<CharT>('0' + val / 10);
+        ++out;
+        *out = static_cast<CharT>('0' + val % 10);
+        ++out;
+
+        return out;
+    }
+
+    // Same as "{:0{width}d}".
+    template <typename CharT, typename OutputIt>
+    OutputIt put_padded_int(OutputIt out, int val, std::size_t width, int limit)
+    {
+        if(val < 0 || val >= limit) [[unlikely]]
+        {
+            return PAPILIO_NS format_to(
+                std::move(out),
+                PAPILIO_TSTRING_VIEW(CharT, "{:0{}d}"),
+                val,
+                width
+            );
+        }
+
+        return put_fixed_digits<CharT>(std::move(out), static_cast<std::uint64_t>(val), width);
+    }
+
+    /**
+     * @brief Writes a time whose specification is accepted by `is_fast_chrono_spec`.
+     *
+     * @param put_subsec Called after the seconds of `%S` and `%T`.
+     * @param put_offset Called for `%z`.
+     */
+    template <typename CharT, typename OutputIt, typename PutSubseconds, typename PutOffset>
+    OutputIt put_fast_chrono(
+        OutputIt out,
+        std::basic_string_view<CharT> spec,
+        const std::tm& t,
+        PutSubseconds put_subsec,
+        PutOffset put_offset
+    )
+    {
+        const int year = t.tm_year + 1900;
+
+        auto put_time = [&](OutputIt it, bool sec) -> OutputIt
+        {
+            it = put_2digits<CharT>(std::move(it), t.tm_hour);
+            *it = CharT(':');
+            ++it;
+            it = put_2digits<CharT>(std::move(it), t.tm_min);
+            if(!sec)
+                return it;
+            *it = CharT(':');
+            ++it;
+            it = put_2digits<CharT>(std::move(it), t.tm_sec);
+            return put_subsec(std::move(it));
+        };
+
+        std::size_t literal_start = 0;
+        for(std::size_t i = 0; i < spec.size(); ++i)
+        {
+            if(spec[i] != CharT('%'))
+                continue;
+
+            out = std::copy(spec.data() + literal_start, spec.data() + i, std::move(out));
+            ++i;
+            PAPILIO_ASSERT(i < spec.size());
+            literal_start = i + 1;
+
+            switch(spec[i])
+            {
+            case CharT('Y'):
+                out = put_padded_int<CharT>(std::move(out), year, 4, 10000);
+                break;
+            case CharT('y'):
+                out = put_2digits<CharT>(std::move(out), year % 100);
+                break;
+            case CharT('m'):
+                out = put_2digits<CharT>(std::move(out), t.tm_mon + 1);
+                break;
+            case CharT('d'):
+                out = put_2digits<CharT>(std::move(out), t.tm_mday);
+                break;
+            case CharT('e'):
+                out = put_2digits<CharT>(std::move(out), t.tm_mday, CharT(' '));
+                break;
+            case CharT('j'):
+                out = put_padded_int<CharT>(std::move(out), t.tm_yday + 1, 3, 1000);
+                break;
+
+            case CharT('H'):
+                out = put_2digits<CharT>(std::move(out), t.tm_hour);
+                break;
+            case CharT('M'):
+                out = put_2digits<CharT>(std::move(out), t.tm_min);
+                break;
+            case CharT('S'):
+                out = put_2digits<CharT>(std::move(out), t.tm_sec);
+                out = put_subsec(std::move(out));
+                break;
+
+            case CharT('F'): // Equivalent to %Y-%m-%d
+                out = put_padded_int<CharT>(std::move(out), year, 4, 10000);
+                *out = CharT('-');
+                ++out;
+                out = put_2digits<CharT>(std::move(out), t.tm_mon + 1);
+                *out = CharT('-');
+                ++out;
+                out = put_2digits<CharT>(std::move(out), t.tm_mday);
+                break;
+            case CharT('D'): // Equivalent to %m/%d/%y
+                out = put_2digits<CharT>(std::move(out), t.tm_mon + 1);
+                *out = CharT('/');
+                ++out;
+                out = put_2digits<CharT>(std::move(out), t.tm_mday);
+                *out = CharT('/');
+                ++out;
+                out = put_2digits<CharT>(std::move(out), year % 100);
+                break;
+            case CharT('T'):
+                out = put_time(std::move(out), true);
+                break;
+            case CharT('R'):
+                out = put_time(std::move(out), false);
+                break;
+
+            case CharT('z'):
+                out = put_offset(std::move(out));
+                break;
+
+            case CharT('n'):
+                *out = CharT('\n');
+                ++out;
+                break;
+            case CharT('t'):
+                *out = CharT('\t');
+                ++out;
+                break;
+            case CharT('%'):
+                *out = CharT('%');
+                ++out;
+                break;
+
+            default:
+                PAPILIO_UNREACHABLE();
+            }
+        }
+
+        return std::copy(spec.data() + literal_start, spec.data() + spec.size(), std::move(out));
+    }
+
+    // String stream imbued with a locale for the locale-aware formatting.
+    // The stream of the current thread is reused while the facets of the locale are unchanged,
+    // so the locale is not copied for every value.
+    // Nested use falls back to a temporary stream.
+    template <typename CharT>
+    class locale_stream
+    {
+    public:
+        using stream_type = std::basic_stringstream<CharT>;
+
+        explicit locale_stream(const std::locale& loc)
+        {
+            cache& c = get_cache();
+            if(c.in_use) [[unlikely]]
+            {
+                m_ss = &m_temp.emplace();
+                m_ss->imbue(loc);
+                return;
+            }
+
+            const auto* numpunct = find_facet<std::numpunct<CharT>>(loc);
+            const auto* time_put = find_facet<std::time_put<CharT>>(loc);
+            if(c.numpunct != numpunct || c.time_put != time_put || !c.imbued)
+            {
+                c.ss.imbue(loc);
+                c.numpunct = numpunct;
+                c.time_put = time_put;
+                c.imbued = true;
+            }
+
+            c.ss.str(std::basic_string<CharT>());
+            c.ss.clear();
+            c.in_use = true;
+
+            m_cache = &c;
+            m_ss = &c.ss;
+        }
+
+        locale_stream(const locale_stream&) = delete;
+
+        ~locale_stream()
+        {
+            if(m_cache)
+                m_cache->in_use = false;
+        }
+
+        [[nodiscard]]
+        stream_type& get() noexcept
+        {
+            return *m_ss;
+        }
+
+        [[nodiscard]]
+        std::basic_string<CharT> str() const
+        {
+            return m_ss->str();
+        }
+
+    private:
+        struct cache
+        {
+            stream_type ss;
+            // The stream keeps a copy of the locale, so these facets are alive while cached
+            const std::numpunct<CharT>* numpunct = nullptr;
+            const std::time_put<CharT>* time_put = nullptr;
+            bool imbued = false;
+            bool in_use = false;
+        };
+
+        static cache& get_cache()
+        {
+            thread_local cache c;
+            return c;
+        }
+
+        cache* m_cache = nullptr;
+        std::optional<stream_type> m_temp;
+        stream_type* m_ss = nullptr;
+    };
+} // namespace detail
+
 #if defined(PAPILIO_COMPILER_CLANG)
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wsign-conversion"
@@ -311,6 +649,7 @@ public:
  *
  * If the specification is empty, it will format the time like `std::asctime` but without the trailing newline.
  * If the specification is not empty, it will pass the time value to `std::put_time` for converting it to string.
+ * Numeric specifications without the `L` option are written directly, unless the year has less or more than four digits.
  */
 PAPILIO_EXPORT template <typename CharT>
 class formatter<std::tm, CharT>
@@ -324,6 +663,8 @@ public:
         auto [result, it] = parser.parse(ctx);
 
         m_data = std::move(result);
+        m_fast = !m_data.basic.use_locale &&
+                 detail::is_fast_chrono_spec(m_data.chrono_spec.to_string_view(), false);
 
         return it;
     }
@@ -343,23 +684,43 @@ public:
             fmt.set_data(m_data.basic);
             return fmt.format(std::basic_string_view<CharT>(buf.data(), buf.size()), ctx);
         }
+        else if(m_fast && 1000 <= val.tm_year + 1900 && val.tm_year + 1900 <= 9999)
+        {
+            // Years out of this range are not padded by std::put_time
+            small_vector<CharT, 64> buf;
+            auto identity = [](auto it)
+            {
+                return it;
+            };
+            detail::put_fast_chrono<CharT>(
+                std::back_inserter(buf),
+                m_data.chrono_spec.to_string_view(),
+                val,
+                identity,
+                identity
+            );
+
+            string_formatter<CharT> fmt;
+            fmt.set_data(m_data.basic);
+            return fmt.format(std::basic_string_view<CharT>(buf.data(), buf.size()), ctx);
+        }
         else
         {
-            std::basic_stringstream<CharT> ss;
-            if(m_data.basic.use_locale)
-                ss.imbue(ctx.getloc());
-            else
-                ss.imbue(std::locale::classic());
-            ss << std::put_time(&val, m_data.chrono_spec.c_str());
+            const locale_ref loc = m_data.basic.use_locale ?
+                                       ctx.getloc_ref() :
+                                       nullptr;
+            detail::locale_stream<CharT> stream(loc.get_ref());
+            stream.get() << std::put_time(&val, m_data.chrono_spec.c_str());
 
             string_formatter<CharT> fmt;
             fmt.set_data(m_data.basic);
-            return fmt.format(std::move(ss).str(), ctx);
+            return fmt.format(stream.str(), ctx);
         }
     }
 
 private:
     chrono_formatter_data<CharT> m_data;
+    bool m_fast = false;
 };
 
 namespace detail
@@ -520,6 +881,53 @@ namespace detail
     }
 } // namespace detail
 
+namespace chrono
+{
+    namespace detail
+    {
+        inline std::atomic<bool> timestamp_cache_flag = true;
+    } // namespace detail
+
+    /**
+     * @brief Enable or disable the timestamp cache.
+     *
+     * When enabled, each thread remembers the text rendered for the last second of a `std::chrono::sys_time`.
+     * Formatting another time point within the same second only re-renders its subseconds.
+     * The cache is only used by numeric specifications without the `L` option.
+     * It is enabled by default.
+     */
+    PAPILIO_EXPORT inline void enable_timestamp_cache(bool enable) noexcept
+    {
+        detail::timestamp_cache_flag.store(enable, std::memory_order_relaxed);
+    }
+
+    PAPILIO_EXPORT [[nodiscard]] inline bool timestamp_cache_enabled() noexcept
+    {
+        return detail::timestamp_cache_flag.load(std::memory_order_relaxed);
+    }
+} // namespace chrono
+
+namespace detail
+{
+    // Text of a timestamp around its subseconds
+    template <typename CharT>
+    struct timestamp_cache
+    {
+        std::basic_string<CharT> spec;
+        std::int64_t seconds = 0;
+        bool has_subseconds = false;
+        std::basic_string<CharT> prefix;
+        std::basic_string<CharT> suffix;
+    };
+
+    template <typename CharT>
+    timestamp_cache<CharT>& get_timestamp_cache()
+    {
+        thread_local timestamp_cache<CharT> cache;
+        return cache;
+    }
+} // namespace detail
+
 /**
  * @brief Base formatter of all chrono types.
  *
@@ -540,6 +948,10 @@ public:
         auto [result, it] = parser.parse(ctx, chrono_traits_type::get_components());
 
         m_data = result;
+        m_fast = !m_data.basic.use_locale &&
+                 detail::is_fast_chrono_spec(m_data.chrono_spec.to_string_view(), true);
+        m_cacheable = m_fast &&
+                      detail::count_seconds_spec(m_data.chrono_spec.to_string_view()) <= 1;
 
         return it;
     }
@@ -561,6 +973,21 @@ public:
                 ctx
             );
         }
+        else if(m_fast)
+        {
+            small_vector<CharT, 64> buf;
+            if constexpr(is_cacheable_type)
+            {
+                if(m_cacheable && chrono::timestamp_cache_enabled())
+                    cached_impl(std::back_inserter(buf), val);
+                else
+                    fast_impl(std::back_inserter(buf), val);
+            }
+            else
+                fast_impl(std::back_inserter(buf), val);
+
+            return fmt.format(std::basic_string_view<CharT>(buf.data(), buf.size()), ctx);
+        }
         else
         {
             return fmt.format(
@@ -572,6 +999,129 @@ public:
 
 private:
     chrono_formatter_data<CharT> m_data;
+    bool m_fast = false;
+    bool m_cacheable = false;
+
+    // Only the system clock with integral representations, whose text is determined by the whole second
+    static constexpr bool is_cacheable_type = []() -> bool
+    {
+        if constexpr(is_specialization_of_v<ChronoType, std::chrono::time_point>)
+        {
+            return std::same_as<typename ChronoType::clock, std::chrono::system_clock> &&
+                   !std::chrono::treat_as_floating_point_v<typename ChronoType::rep>;
+        }
+        else
+            return false;
+    }();
+
+    template <typename OutputIt>
+    OutputIt fast_impl(OutputIt out, const ChronoType& val) const
+    {
+        auto put_subsec = [&val](OutputIt it) -> OutputIt
+        {
+            if constexpr(detail::has_fractional_width<ChronoType>())
+                return put_fast_subseconds(std::move(it), val);
+            else
+                return it;
+        };
+
+        return put_fast_chrono_with(std::move(out), val, put_subsec);
+    }
+
+    template <typename OutputIt, typename PutSubseconds>
+    OutputIt put_fast_chrono_with(OutputIt out, const ChronoType& val, PutSubseconds put_subsec) const
+    {
+        auto put_offset = [&val](OutputIt it) -> OutputIt
+        {
+            return PAPILIO_NS chrono::get_timezone_info(val).template copy_offset<CharT>(std::move(it), false);
+        };
+
+        return detail::put_fast_chrono<CharT>(
+            std::move(out),
+            m_data.chrono_spec.to_string_view(),
+            chrono_traits_type::to_tm(val),
+            put_subsec,
+            put_offset
+        );
+    }
+
+    // Reuses the text of the last second rendered by this thread with the same specification.
+    template <typename OutputIt>
+    OutputIt cached_impl(OutputIt out, const ChronoType& val) const
+    {
+        const auto spec = m_data.chrono_spec.to_string_view();
+        const auto seconds = static_cast<std::int64_t>(
+            std::chrono::floor<std::chrono::seconds>(val).time_since_epoch().count()
+        );
+
+        detail::timestamp_cache<CharT>& cache = detail::get_timestamp_cache<CharT>();
+        if(cache.seconds != seconds || cache.spec != spec)
+        {
+            small_vector<CharT, 64> buf;
+            std::optional<std::size_t> split;
+            auto mark_subsec = [&buf, &split](auto it)
+            {
+                split = buf.size();
+                return it;
+            };
+            put_fast_chrono_with(std::back_inserter(buf), val, mark_subsec);
+
+            cache.spec.assign(spec);
+            cache.seconds = seconds;
+            cache.has_subseconds = split.has_value();
+            cache.prefix.assign(buf.data(), split.value_or(buf.size()));
+            cache.suffix.assign(buf.data() + cache.prefix.size(), buf.size() - cache.prefix.size());
+        }
+
+        out = std::copy(cache.prefix.begin(), cache.prefix.end(), std::move(out));
+        if constexpr(detail::has_fractional_width<ChronoType>())
+        {
+            if(cache.has_subseconds)
+                out = put_fast_subseconds(std::move(out), val);
+        }
+        return std::copy(cache.suffix.begin(), cache.suffix.end(), std::move(out));
+    }
+
+    template <typename OutputIt, typename T>
+    static OutputIt put_fast_subseconds(OutputIt out, const T& val)
+    {
+        using namespace std::chrono;
+
+        if constexpr(is_specialization_of_v<T, time_point>)
+            return put_fast_subseconds(std::move(out), val.time_since_epoch());
+        else
+        {
+            using hh_mm_ss_type = std::conditional_t<
+                is_specialization_of_v<T, hh_mm_ss>,
+                T,
+                hh_mm_ss<T>>;
+            using rep = typename hh_mm_ss_type::precision::rep;
+
+            if constexpr(treat_as_floating_point_v<rep>)
+                return detail::put_subseconds<CharT>(std::move(out), val);
+            else
+            {
+                rep count;
+                if constexpr(is_specialization_of_v<T, hh_mm_ss>)
+                    count = val.subseconds().count();
+                else
+                {
+                    auto abs_val = abs(val);
+                    count = duration_cast<typename hh_mm_ss_type::precision>(
+                                abs_val - duration_cast<seconds>(abs_val)
+                    )
+                                .count();
+                }
+
+                out = detail::put_decimal_point<CharT>(std::move(out));
+                return detail::put_fixed_digits<CharT>(
+                    std::move(out),
+                    static_cast<std::uint64_t>(count),
+                    hh_mm_ss_type::fractional_width
+                );
+            }
+        }
+    }
 
     static std::basic_string<CharT> default_impl(locale_ref loc, const ChronoType& val)
     {
@@ -596,12 +1146,19 @@ private:
 
         const auto sentinel = spec.end();
 
-        std::basic_stringstream<CharT> ss;
+        std::optional<detail::locale_stream<CharT>> loc_stream;
+        std::optional<std::basic_stringstream<CharT>> plain_stream;
+        const std::time_put<CharT>* facet = nullptr;
         if(use_locale)
-            ss.imbue(loc);
-        const std::time_put<CharT>* facet = use_locale ?
-                                                std::addressof(std::use_facet<std::time_put<CharT>>(ss.getloc())) :
-                                                nullptr;
+        {
+            facet = std::addressof(std::use_facet<std::time_put<CharT>>(loc.get_ref()));
+            loc_stream.emplace(loc.get_ref());
+        }
+        else
+            plain_stream.emplace();
+        std::basic_stringstream<CharT>& ss = use_locale ?
+                                                 loc_stream->get() :
+                                                 *plain_stream;
 
         for(auto it = spec.begin(); it != sentinel; ++it)
         {
@@ -960,7 +1517,10 @@ private:
             }
         }
 
-        return std::move(ss).str();
+        if(use_locale)
+            return loc_stream->str();
+        else
+            return std::move(*plain_stream).str();
     }
 
     [[noreturn]]
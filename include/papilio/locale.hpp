@@ -10,11 +10,134 @@
 #pragma once
 
 #include <locale>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <optional>
 #include "fmtfwd.hpp"
 #include "detail/prefix.hpp"
 
 namespace papilio
 {
+namespace detail
+{
+    template <typename Facet>
+    const Facet* find_facet(const std::locale& loc) noexcept
+    {
+        if(!std::has_facet<Facet>(loc))
+            return nullptr;
+        return std::addressof(std::use_facet<Facet>(loc));
+    }
+
+    // Numeric punctuation of a locale
+    template <typename CharT>
+    struct locale_punct
+    {
+        CharT decimal_point = CharT('.');
+        CharT thousands_sep = CharT(',');
+        // Short enough for the small string optimization in practice
+        std::string grouping;
+    };
+
+    // Caches the punctuation of the recently used locales in the current thread.
+    // The entries are keyed by the addresses of the numpunct facets.
+    // Each entry keeps a copy of its locale, so an address cannot be reused by another facet while cached.
+    template <typename CharT>
+    class locale_punct_cache
+    {
+    public:
+        using numpunct_type = std::numpunct<CharT>;
+
+        [[nodiscard]]
+        static const locale_punct<CharT>& get(const std::locale& loc)
+        {
+            thread_local locale_punct_cache cache;
+            return cache.get_impl(loc);
+        }
+
+    private:
+        static constexpr std::size_t entry_count = 4;
+
+        struct entry
+        {
+            std::locale loc;
+            const numpunct_type* facet;
+            locale_punct<CharT> punct;
+        };
+
+        std::optional<entry> m_entries[entry_count];
+        std::size_t m_next_entry = 0;
+        // Facets missed recently, which are cached on the next miss
+        const numpunct_type* m_candidates[entry_count] = {};
+        std::size_t m_next_candidate = 0;
+        // Punctuation of the last locale that is not cached
+        locale_punct<CharT> m_uncached;
+
+        const locale_punct<CharT>& get_impl(const std::locale& loc)
+        {
+            const numpunct_type* facet = find_facet<numpunct_type>(loc);
+            if(!facet) [[unlikely]]
+            {
+                m_uncached = locale_punct<CharT>();
+                return m_uncached;
+            }
+
+            for(const auto& e : m_entries)
+            {
+                if(e && e->facet == facet)
+                    return e->punct;
+            }
+
+            // Locales are cached on their second miss,
+            // so rotating through more locales than the entries does not copy a locale for every call.
+            if(take_candidate(facet))
+            {
+                auto& e = m_entries[m_next_entry].emplace(entry{loc, facet, {}});
+                m_next_entry = (m_next_entry + 1) % entry_count;
+
+                load(e.punct, *facet);
+                return e.punct;
+            }
+
+            m_candidates[m_next_candidate] = facet;
+            m_next_candidate = (m_next_candidate + 1) % entry_count;
+
+            load(m_uncached, *facet);
+            return m_uncached;
+        }
+
+        static void load(locale_punct<CharT>& punct, const numpunct_type& facet)
+        {
+            punct.decimal_point = facet.decimal_point();
+            punct.thousands_sep = facet.thousands_sep();
+            punct.grouping = facet.grouping();
+        }
+
+        bool take_candidate(const numpunct_type* facet) noexcept
+        {
+            for(auto& c : m_candidates)
+            {
+                if(c == facet)
+                {
+                    c = nullptr;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    // Repeated calls with the same locale neither copy the locale nor call the virtual functions of the facet.
+    // The result is valid until the next call in the current thread.
+    template <typename CharT>
+    [[nodiscard]]
+    const locale_punct<CharT>& get_locale_punct(const std::locale& loc)
+    {
+        return locale_punct_cache<CharT>::get(loc);
+    }
+} // namespace detail
+
 /**
  * @brief Reference to a locale object.
  */
@@ -63,6 +186,19 @@ public:
     [[nodiscard]]
     std::locale get() const;
 
+    /**
+     * @brief Get a reference to the referenced locale object without copying it.
+     *
+     * If the reference is empty, `std::locale::classic()` will be returned.
+     */
+    [[nodiscard]]
+    const std::locale& get_ref() const noexcept
+    {
+        return m_loc == nullptr ?
+                   std::locale::classic() :
+                   *m_loc;
+    }
+
     /**
      * @brief A shortcut for `get()`.
      *
@@ -77,7 +213,7 @@ private:
     const std::locale* m_loc = nullptr;
 };
 
-char index_grouping(const std::string& grouping, std::size_t idx);
+char index_grouping(std::string_view grouping, std::size_t idx);
 } // namespace papilio
 
 #include "detail/suffix.hpp"
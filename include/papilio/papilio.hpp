@@ -32,6 +32,7 @@
 #include "macros.hpp"
 #include "core.hpp"
 #include "format.hpp"
+#include "compile.hpp"
 #include "print.hpp"
 #include "detail/prefix.hpp"
 
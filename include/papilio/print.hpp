@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include "os/os.hpp"
 #include "format.hpp"
 #include "color.hpp"
@@ -25,11 +26,12 @@ namespace papilio
 
 namespace detail
 {
+    // Formats into a reusable buffer of the current thread and writes it to the file at once.
     void vprint_impl(
         std::FILE* file,
         std::string_view fmt,
+        const fmt_segment_table& segments,
         format_args_ref args,
-        bool conv_unicode,
         bool newline,
         text_style st = text_style()
     );
@@ -46,8 +48,8 @@ void print(std::FILE* file, format_string<Args...> fmt, Args&&... args)
     detail::vprint_impl(
         file,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args(std::forward<Args>(args)...),
-        os::is_terminal(file),
         false
     );
 }
@@ -58,8 +60,8 @@ void println(std::FILE* file, format_string<Args...> fmt, Args&&... args)
     detail::vprint_impl(
         file,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args(std::forward<Args>(args)...),
-        os::is_terminal(file),
         true
     );
 }
@@ -86,8 +88,8 @@ void print(text_style st, format_string<Args...> fmt, Args&&... args)
     detail::vprint_impl(
         stdout,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args(std::forward<Args>(args)...),
-        os::is_terminal(stdout),
         false,
         st
     );
@@ -105,8 +107,8 @@ void println(text_style st, format_string<Args...> fmt, Args&&... args)
     detail::vprint_impl(
         stdout,
         fmt.get(),
+        fmt.segments(),
         PAPILIO_NS make_format_args(std::forward<Args>(args)...),
-        os::is_terminal(stdout),
         true,
         st
     );
@@ -141,6 +143,100 @@ void println(std::ostream& os, format_string<Args...> fmt, Args&&... args)
 
 /// @}
 
+/// @defgroup PrintAsync Print asynchronously
+/// @brief Format on the calling thread and write the results on a background thread.
+/// @{
+
+/**
+ * @brief Sink that writes formatted lines to a file from a background writer thread.
+ *
+ * Producers format on their own thread and enqueue the result to a lock-free queue.
+ * The writer thread concatenates all pending results and writes them to the file at once,
+ * so calling threads never wait for the file unless the queue is full.
+ *
+ * The file must remain valid until the sink is destroyed. The destructor writes all pending results.
+ */
+PAPILIO_EXPORT class async_sink
+{
+public:
+    /**
+     * @brief Behavior of producers when the number of pending results reaches the capacity.
+     */
+    enum class overflow_policy
+    {
+        block, ///< Wait until the writer thread catches up.
+        drop, ///< Discard the result. Discarded results can be counted by @ref dropped.
+        grow ///< Ignore the capacity.
+    };
+
+    /**
+     * @brief Create a sink and start its writer thread.
+     *
+     * @param file Destination file
+     * @param capacity Maximum number of pending results
+     * @param policy Behavior when the capacity is reached
+     */
+    explicit async_sink(
+        std::FILE* file = stdout,
+        std::size_t capacity = 8192,
+        overflow_policy policy = overflow_policy::block
+    );
+
+    async_sink(const async_sink&) = delete;
+
+    ~async_sink();
+
+    async_sink& operator=(const async_sink&) = delete;
+
+    template <typename... Args>
+    void print(format_string<Args...> fmt, Args&&... args)
+    {
+        vprint(
+            fmt.get(),
+            fmt.segments(),
+            PAPILIO_NS make_format_args(std::forward<Args>(args)...),
+            false
+        );
+    }
+
+    template <typename... Args>
+    void println(format_string<Args...> fmt, Args&&... args)
+    {
+        vprint(
+            fmt.get(),
+            fmt.segments(),
+            PAPILIO_NS make_format_args(std::forward<Args>(args)...),
+            true
+        );
+    }
+
+    /**
+     * @brief Wait until everything enqueued before this call has been written.
+     *
+     * @throw std::system_error If the writer thread failed to write to the file.
+     */
+    void flush();
+
+    /**
+     * @brief Number of results discarded by the `drop` policy.
+     */
+    [[nodiscard]]
+    std::size_t dropped() const noexcept;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+
+    void vprint(
+        std::string_view fmt,
+        const detail::fmt_segment_table& segments,
+        format_args_ref args,
+        bool newline
+    );
+};
+
+/// @}
+
 /// @}
 } // namespace papilio
 
@@ -119,7 +119,165 @@ public:
     static auto from_codepoint(codepoint cp) -> from_codepoint_result;
 };
 
-// ^^^ decoders ^^^ / vvv codepoint vvv
+// ^^^ decoders ^^^ / vvv width estimation vvv
+
+namespace detail
+{
+    /**
+     * @brief Two-level lookup table for estimating the display width of code points.
+     *
+     * The first level maps every block of 256 code points to a kind:
+     * 0 for a block of narrow code points, 1 for a block of wide code points,
+     * or `2 + i` for a mixed block whose widths are stored in the `i`-th bitmap of the second level.
+     */
+    class width_table
+    {
+    public:
+        static constexpr unsigned int block_bits = 8;
+        static constexpr char32_t block_size = char32_t(1) << block_bits;
+        // All code points after this are narrow.
+        static constexpr char32_t limit = 0x40000;
+
+        static constexpr std::size_t block_count = limit / block_size;
+        static constexpr std::size_t max_bitmaps = 16;
+
+        // [begin, end) intervals of wide code points
+        static constexpr std::pair<char32_t, char32_t> wide_intervals[] = {
+            { 0x1100u,  0x1160u},
+            { 0x2329u,  0x232Bu},
+            { 0x2E80u,  0x303Fu},
+            { 0x3040u,  0xA4D0u},
+            { 0xAC00u,  0xD7A4u},
+            { 0xF900u,  0xFB00u},
+            { 0xFE10u,  0xFE1Au},
+            { 0xFE30u,  0xFE70u},
+            { 0xFF00u,  0xFF61u},
+            { 0xFFE0u,  0xFFE7u},
+            {0x1F300u, 0x1F650u},
+            {0x1F900u, 0x1FA00u},
+            {0x20000u, 0x2FFFEu},
+            {0x30000u, 0x3FFFEu}
+        };
+
+        // The first code point that may be wide
+        static constexpr char32_t first_wide = wide_intervals[0].first;
+
+        constexpr width_table() noexcept
+        {
+            std::size_t bitmap_count = 0;
+
+            for(std::size_t i = 0; i < block_count; ++i)
+            {
+                const char32_t block_begin = static_cast<char32_t>(i) << block_bits;
+                const char32_t block_end = block_begin + block_size;
+
+                char32_t wide_count = 0;
+                for(const auto& [begin, end] : wide_intervals)
+                {
+                    const char32_t first = begin < block_begin ? block_begin : begin;
+                    const char32_t last = end < block_end ? end : block_end;
+                    if(first < last)
+                        wide_count += last - first;
+                }
+
+                if(wide_count == 0)
+                    m_blocks[i] = 0;
+                else if(wide_count == block_size)
+                    m_blocks[i] = 1;
+                else
+                {
+                    auto& bitmap = m_bitmaps[bitmap_count];
+                    for(char32_t off = 0; off < block_size; ++off)
+                    {
+                        if(is_wide(block_begin + off))
+                            bitmap[off / 64] |= std::uint64_t(1) << (off % 64);
+                    }
+
+                    m_blocks[i] = static_cast<std::uint8_t>(2 + bitmap_count);
+                    ++bitmap_count;
+                }
+            }
+        }
+
+        [[nodiscard]]
+        constexpr std::size_t lookup(char32_t ch) const noexcept
+        {
+            if(ch < first_wide || ch >= limit) [[likely]]
+                return 1;
+
+            const std::uint8_t kind = m_blocks[ch >> block_bits];
+            if(kind < 2)
+                return kind + 1;
+
+            const char32_t off = ch & (block_size - 1);
+            return ((m_bitmaps[kind - 2][off / 64] >> (off % 64)) & 1u) + 1;
+        }
+
+    private:
+        std::uint8_t m_blocks[block_count] = {};
+        std::uint64_t m_bitmaps[max_bitmaps][block_size / 64] = {};
+
+        static constexpr bool is_wide(char32_t ch) noexcept
+        {
+            for(const auto& [begin, end] : wide_intervals)
+            {
+                if(begin <= ch && ch < end)
+                    return true;
+            }
+
+            return false;
+        }
+    };
+
+    inline constexpr width_table width_lut{};
+} // namespace detail
+
+/**
+ * @brief Estimate the display width of a code point.
+ *
+ * @return 2 for East Asian wide characters and emojis, otherwise 1.
+ */
+PAPILIO_EXPORT [[nodiscard]]
+constexpr std::size_t estimate_width(char32_t ch) noexcept
+{
+    return detail::width_lut.lookup(ch);
+}
+
+/**
+ * @brief Estimate the display width of a string.
+ *
+ * It is equivalent to the sum of the estimated widths of all code points,
+ * but ASCII text is processed by blocks without decoding.
+ */
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::string_view str);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u8string_view str);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u16string_view str);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u32string_view str) noexcept;
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::wstring_view str);
+
+/**
+ * @brief Estimate the display width of a string, stopping early once it reaches `max_width`.
+ *
+ * @return The width of the whole string if it is narrower than `max_width`,
+ *         otherwise a value not less than `max_width`.
+ */
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::string_view str, std::size_t max_width);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u8string_view str, std::size_t max_width);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u16string_view str, std::size_t max_width);
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::u32string_view str, std::size_t max_width) noexcept;
+PAPILIO_EXPORT [[nodiscard]]
+std::size_t estimate_width(std::wstring_view str, std::size_t max_width);
+
+// ^^^ width estimation ^^^ / vvv codepoint vvv
 
 #ifdef PAPILIO_COMPILER_MSVC
 #    pragma warning(push)
@@ -343,34 +501,15 @@ public:
     friend std::basic_ostream<char16_t>& operator<<(std::basic_ostream<char16_t>& os, codepoint cp);
     friend std::basic_ostream<char32_t>& operator<<(std::basic_ostream<char32_t>& os, codepoint cp);
 
-    constexpr std::size_t estimate_width() const
+    /**
+     * @brief Estimate the display width of the code point.
+     *
+     * @sa utf::estimate_width
+     */
+    [[nodiscard]]
+    constexpr std::size_t estimate_width() const noexcept
     {
-        // [begin, end) intervals
-        constexpr std::pair<char32_t, char32_t> estimate_intervals[] = {
-            { 0x1100u,  0x1160u},
-            { 0x2329u,  0x232Bu},
-            { 0x2E80u,  0x303Fu},
-            { 0x3040u,  0xA4D0u},
-            { 0xAC00u,  0xD7A4u},
-            { 0xF900u,  0xFB00u},
-            { 0xFE10u,  0xFE1Au},
-            { 0xFE30u,  0xFE70u},
-            { 0xFF00u,  0xFF61u},
-            { 0xFFE0u,  0xFFE7u},
-            {0x1F300u, 0x1F650u},
-            {0x1F900u, 0x1FA00u},
-            {0x20000u, 0x2FFFEu},
-            {0x30000u, 0x3FFFEu}
-        };
-
-        char32_t ch = static_cast<char32_t>(*this);
-        for(const auto& i : estimate_intervals)
-        {
-            if(i.first <= ch && ch < i.second)
-                return 2;
-        }
-
-        return 1;
+        return utf::estimate_width(static_cast<char32_t>(*this));
     }
 
 #if defined(PAPILIO_COMPILER_CLANG)
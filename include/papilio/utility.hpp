@@ -17,6 +17,8 @@
 #include <concepts>
 #include <string>
 #include <array>
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <iostream>
 #include "macros.hpp"
@@ -377,46 +379,103 @@ constexpr auto arg(const std::basic_string_view<CharT> name, T&& value) noexcept
 
 namespace detail
 {
-    template <typename CharT>
-    struct named_arg_proxy
+    /**
+     * @brief String literal used as a template argument.
+     */
+    template <typename CharT, std::size_t N>
+    struct fixed_arg_name
     {
-        using string_view_type = std::basic_string_view<CharT>;
+        using char_type = CharT;
 
-        string_view_type name;
+        CharT data[N]{};
 
-        named_arg_proxy() = delete;
-        named_arg_proxy(const named_arg_proxy&) = delete;
+        consteval fixed_arg_name(const CharT (&str)[N]) noexcept
+        {
+            std::copy_n(str, N, data);
+        }
+
+        [[nodiscard]]
+        constexpr std::basic_string_view<CharT> get() const noexcept
+        {
+            return std::basic_string_view<CharT>(data, N - 1);
+        }
+    };
+} // namespace detail
+
+/**
+ * @brief Named argument whose name is known at compile time.
+ *
+ * Replacement fields referring to it in a format string checked at compile time
+ * are resolved to the position of the argument, so no name lookup happens when formatting.
+ *
+ * @sa basic_named_arg
+ */
+PAPILIO_EXPORT template <detail::fixed_arg_name Name, typename T>
+struct static_named_arg : public basic_named_arg<typename decltype(Name)::char_type, T>
+{
+    using my_base = basic_named_arg<typename decltype(Name)::char_type, T>;
+
+    using typename my_base::string_view_type;
+    using typename my_base::reference;
+
+    static constexpr string_view_type static_name = Name.get();
+
+    constexpr explicit static_named_arg(reference arg_value) noexcept
+        : my_base(static_name, arg_value) {}
+
+    constexpr static_named_arg(const static_named_arg&) noexcept = default;
+};
+
+/**
+ * @brief Create a named argument whose name is known at compile time.
+ *
+ * @code{.cpp}
+ * papilio::format("{name}", papilio::arg<"name">(value));
+ * @endcode
+ */
+PAPILIO_EXPORT template <detail::fixed_arg_name Name, typename T>
+constexpr auto arg(T&& value) noexcept
+{
+    return static_named_arg<Name, std::remove_reference_t<T>>(value);
+}
 
-        constexpr named_arg_proxy(const CharT* arg_name, std::size_t size) noexcept
-            : name(arg_name, size) {}
+namespace detail
+{
+    template <fixed_arg_name Name>
+    struct named_arg_proxy
+    {
+        named_arg_proxy() = default;
+        named_arg_proxy(const named_arg_proxy&) = delete;
 
         named_arg_proxy& operator=(const named_arg_proxy&) = delete;
 
         template <typename T>
         [[nodiscard]]
-        constexpr auto operator=(T&& value) noexcept
+        constexpr auto operator=(T&& value) const noexcept
         {
-            return PAPILIO_NS arg(name, std::forward<T>(value));
+            return PAPILIO_NS arg<Name>(std::forward<T>(value));
         }
     };
+
+    template <typename T>
+    concept has_static_arg_name = requires() {
+        { T::static_name } -> std::convertible_to<std::basic_string_view<typename T::char_type>>;
+    };
 } // namespace detail
 
 inline namespace literals
 {
     inline namespace named_arg_literals
     {
-        PAPILIO_EXPORT constexpr auto operator""_a(
-            const char* name, std::size_t size
-        ) noexcept
+        /**
+         * @brief Create a named argument by `"name"_a = value`.
+         *
+         * The name is a template argument, so the result is a @ref static_named_arg.
+         */
+        PAPILIO_EXPORT template <detail::fixed_arg_name Name>
+        constexpr auto operator""_a() noexcept
         {
-            return PAPILIO_NS detail::named_arg_proxy<char>(name, size);
-        }
-
-        PAPILIO_EXPORT constexpr auto operator""_a(
-            const wchar_t* name, std::size_t size
-        ) noexcept
-        {
-            return PAPILIO_NS detail::named_arg_proxy<wchar_t>(name, size);
+            return PAPILIO_NS detail::named_arg_proxy<Name>();
         }
     } // namespace named_arg_literals
 } // namespace literals
@@ -1031,6 +1090,10 @@ namespace detail
 
 #endif
 
+        // Invalid values are printed as casts, e.g. "(my_enum)5"
+        if(name.empty() || name.front() == '(' || name.front() == '-' || ('0' <= name.front() && name.front() <= '9'))
+            return std::string_view();
+
         // Remove qualifier
         std::size_t qual_end = name.rfind("::");
         if(qual_end != std::string_view::npos)
@@ -1048,9 +1111,10 @@ namespace detail
  *
  * @tparam Value The enum value
  *
+ * @return The name of the enum value, or an empty string if the value is invalid.
+ *
  * @warning This function has some limitations.
  * - For multiple enum with same value, the result will be one of them, depending on the compiler.
- * - For invalid enum value, the result is undefined.
  */
 PAPILIO_EXPORT template <auto Value>
 constexpr std::string_view static_enum_name()
@@ -1058,29 +1122,223 @@ constexpr std::string_view static_enum_name()
     return detail::static_enum_name_impl<Value>();
 }
 
+/**
+ * @brief Range of values searched for the names of an enumeration.
+ *
+ * The default range is `[-128, 127]`, clamped to the range of the underlying type.
+ * Specialize it for enumerations with values out of the default range.
+ * Every value in the range is instantiated once, so a narrower range also reduces the compile time.
+ *
+ * @code{.cpp}
+ * template <>
+ * struct papilio::enum_range<my_enum>
+ * {
+ *     static constexpr std::int64_t min = 0;
+ *     static constexpr std::int64_t max = 1000;
+ * };
+ * @endcode
+ */
+PAPILIO_EXPORT template <typename T>
+requires std::is_enum_v<T>
+struct enum_range
+{
+    static constexpr std::int64_t min = -128;
+    static constexpr std::int64_t max = 127;
+};
+
+/**
+ * @brief Enable the decomposition of combined values of a flag enumeration, e.g. `read|write`.
+ *
+ * Only the values of single bits are searched for the names of flag enumerations,
+ * so `enum_range` is ignored and the flags can use all bits of the underlying type.
+ */
+PAPILIO_EXPORT template <typename T>
+requires std::is_enum_v<T>
+inline constexpr bool enable_enum_flags = false;
+
+namespace detail
+{
+    template <typename T>
+    struct enum_entry
+    {
+        std::underlying_type_t<T> value;
+        std::string_view name;
+    };
+
+    template <typename T>
+    struct enum_candidates
+    {
+        using underlying_type = std::underlying_type_t<T>;
+        using limits = std::numeric_limits<underlying_type>;
+
+        static constexpr std::int64_t min =
+            std::max<std::int64_t>(enum_range<T>::min, static_cast<std::int64_t>(limits::min()));
+        static constexpr std::int64_t max = std::min<std::int64_t>(
+            enum_range<T>::max,
+            static_cast<std::int64_t>(std::min<std::uint64_t>(limits::max(), std::numeric_limits<std::int64_t>::max()))
+        );
+
+        // Zero and the single bits for flags, or all values in the range otherwise
+        static constexpr std::size_t count =
+            enable_enum_flags<T> ?
+                static_cast<std::size_t>(limits::digits + limits::is_signed) + 1 :
+                static_cast<std::size_t>(max >= min ? max - min + 1 : 0);
+
+        static constexpr underlying_type get(std::size_t i) noexcept
+        {
+            if constexpr(enable_enum_flags<T>)
+            {
+                using unsigned_type = std::make_unsigned_t<underlying_type>;
+                if(i == 0)
+                    return underlying_type(0);
+                return static_cast<underlying_type>(static_cast<unsigned_type>(unsigned_type(1) << (i - 1)));
+            }
+            else
+                return static_cast<underlying_type>(min + static_cast<std::int64_t>(i));
+        }
+    };
+
+    template <typename T>
+    inline constexpr auto enum_candidate_names = []<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        return std::array<std::string_view, sizeof...(Is)>{
+            detail::static_enum_name_impl<std::bit_cast<T>(enum_candidates<T>::get(Is))>()...
+        };
+    }(std::make_index_sequence<enum_candidates<T>::count>());
+
+    /**
+     * @brief Names of the valid values of an enumeration, sorted by value and computed once at compile time.
+     */
+    template <typename T>
+    inline constexpr auto enum_entries = []()
+    {
+        constexpr auto& names = enum_candidate_names<T>;
+
+        constexpr auto count = static_cast<std::size_t>(std::ranges::count_if(
+            names, [](std::string_view n)
+            { return !n.empty(); }
+        ));
+
+        std::array<enum_entry<T>, count> result{};
+        std::size_t idx = 0;
+        for(std::size_t i = 0; i < names.size(); ++i)
+        {
+            if(!names[i].empty())
+                result[idx++] = enum_entry<T>{enum_candidates<T>::get(i), names[i]};
+        }
+
+        // The sign bit of flags comes first
+        std::ranges::sort(
+            result,
+            [](const enum_entry<T>& lhs, const enum_entry<T>& rhs)
+            { return lhs.value < rhs.value; }
+        );
+
+        return result;
+    }();
+
+    // The valid values are contiguous, so they can be found by index.
+    template <typename T>
+    inline constexpr bool enum_entries_dense = []()
+    {
+        constexpr auto& entries = enum_entries<T>;
+
+        if constexpr(entries.empty())
+            return false;
+        else
+        {
+            const auto diff = static_cast<std::uint64_t>(
+                static_cast<std::int64_t>(entries.back().value) - static_cast<std::int64_t>(entries.front().value)
+            );
+            return diff + 1 == entries.size();
+        }
+    }();
+
+    template <typename T>
+    constexpr std::string_view find_enum_name(T value) noexcept
+    {
+        using underlying_type = std::underlying_type_t<T>;
+
+        constexpr auto& entries = enum_entries<T>;
+        const auto val = static_cast<underlying_type>(value);
+
+        if constexpr(entries.empty())
+            return std::string_view();
+        else if constexpr(enum_entries_dense<T>)
+        {
+            if(val < entries.front().value || val > entries.back().value)
+                return std::string_view();
+
+            const auto idx = static_cast<std::size_t>(
+                static_cast<std::int64_t>(val) - static_cast<std::int64_t>(entries.front().value)
+            );
+            return entries[idx].name;
+        }
+        else
+        {
+            auto it = std::ranges::lower_bound(entries, val, {}, &enum_entry<T>::value);
+            if(it == entries.end() || it->value != val)
+                return std::string_view();
+            return it->name;
+        }
+    }
+} // namespace detail
+
 /**
  * @brief Convert an enum value to string at runtime.
  *
+ * The names are looked up in a table computed once at compile time for each enumeration.
+ *
  * @param value The enum value.
  *
- * @warning This function has some limitations.
- * - It can only convert valid enum values ranging from -128 to 128.
+ * @return The name of the value, or an empty string if the value is out of `enum_range` or invalid.
  *
- * @sa static_enum_name
+ * @sa static_enum_name, enum_range
  */
 PAPILIO_EXPORT template <typename T>
 requires std::is_enum_v<T>
 constexpr std::string_view enum_name(T value) noexcept
 {
-    auto names = [=]<ssize_t... Is>(std::integer_sequence<ssize_t, Is...>)
+    return detail::find_enum_name(value);
+}
+
+/**
+ * @brief Convert a combined value of flag enumeration to string, e.g. `read|write`.
+ *
+ * @param value The enum value.
+ * @param sep Separator between the names.
+ *
+ * @return The names of the set bits, or an empty string if any of the set bits has no name.
+ *
+ * @sa enable_enum_flags
+ */
+PAPILIO_EXPORT template <typename T>
+requires std::is_enum_v<T> && enable_enum_flags<T>
+std::string enum_flags_name(T value, std::string_view sep = "|")
+{
+    using underlying_type = std::underlying_type_t<T>;
+    using unsigned_type = std::make_unsigned_t<underlying_type>;
+
+    if(std::string_view name = detail::find_enum_name(value); !name.empty())
+        return std::string(name);
+
+    std::string result;
+    unsigned_type remaining = static_cast<unsigned_type>(static_cast<underlying_type>(value));
+    for(const auto& e : detail::enum_entries<T>)
     {
-        using underlying_t = std::underlying_type_t<T>;
-        return std::array<std::string_view, 256>{
-            detail::static_enum_name_impl<std::bit_cast<T>(underlying_t(Is - 128))>()...
-        };
-    }(std::make_integer_sequence<ssize_t, 256>());
+        const unsigned_type bit = static_cast<unsigned_type>(e.value);
+        if((remaining & bit) == 0)
+            continue;
+
+        if(!result.empty())
+            result += sep;
+        result += e.name;
+        remaining = static_cast<unsigned_type>(remaining & ~bit);
+    }
 
-    return names[static_cast<std::size_t>(value) + 128];
+    if(remaining != 0 || result.empty())
+        return std::string();
+    return result;
 }
 
 #if defined PAPILIO_COMPILER_CLANG
@@ -99,6 +99,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u8string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char8_t>>& args
     );
 }
@@ -113,6 +114,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<char8_t>(
         nullptr,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -196,6 +198,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u16string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char16_t>>& args
     );
 }
@@ -210,6 +213,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<char16_t>(
         nullptr,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -294,6 +298,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u32string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char32_t>>& args
     );
 }
@@ -308,6 +313,7 @@ std::size_t formatted_size(
     return detail::formatted_size_helper<char32_t>(
         nullptr,
         fmt.get(),
+        fmt.segments(),
         std::forward<Args>(args)...
     );
 }
@@ -15,6 +15,12 @@ module;
 #include <array>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <exception>
 #include <ranges>
 #include <variant>
 #include <iterator>
@@ -36,6 +42,7 @@ export module papilio;
 #include <papilio/macros.hpp>
 #include <papilio/core.hpp>
 #include <papilio/format.hpp>
+#include <papilio/compile.hpp>
 #include <papilio/papilio.hpp>
 
 #include "../src/container.cpp"
@@ -1,4 +1,5 @@
 #include <papilio/core.hpp>
+#include <atomic>
 #include <papilio/detail/prefix.hpp>
 
 namespace papilio
@@ -102,6 +103,21 @@ script_base::error script_base::make_error(script_error_code ec)
     return error(ec);
 }
 
+namespace detail
+{
+    static std::atomic<bool> script_cache_flag = true;
+} // namespace detail
+
+void script_base::enable_script_cache(bool enable) noexcept
+{
+    detail::script_cache_flag.store(enable, std::memory_order_relaxed);
+}
+
+bool script_base::script_cache_enabled() noexcept
+{
+    return detail::script_cache_flag.load(std::memory_order_relaxed);
+}
+
 void script_base::throw_end_of_string()
 {
     throw make_error(script_error_code::end_of_string);
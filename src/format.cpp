@@ -45,9 +45,44 @@ std::wstring vformat(
 
 namespace detail
 {
+    std::string vformat_impl(
+        locale_ref loc,
+        std::string_view fmt,
+        const fmt_segment_table& segments,
+        const format_args_ref& args
+    )
+    {
+        using iter_t = format_iterator_for<char>;
+
+        std::string result;
+        vformat_to_impl<char, iter_t, format_context>(
+            std::back_inserter(result), loc, fmt, segments, args
+        );
+
+        return result;
+    }
+
+    std::wstring vformat_impl(
+        locale_ref loc,
+        std::wstring_view fmt,
+        const fmt_segment_table& segments,
+        const wformat_args_ref& args
+    )
+    {
+        using iter_t = format_iterator_for<wchar_t>;
+
+        std::wstring result;
+        vformat_to_impl<wchar_t, iter_t, wformat_context>(
+            std::back_inserter(result), loc, fmt, segments, args
+        );
+
+        return result;
+    }
+
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char>>& args
     )
     {
@@ -58,6 +93,7 @@ namespace detail
                    iter_t(),
                    loc,
                    fmt,
+                   segments,
                    args
         )
             .get_result();
@@ -66,6 +102,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::wstring_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<wchar_t>>& args
     )
     {
@@ -76,6 +113,7 @@ namespace detail
                    iter_t(),
                    loc,
                    fmt,
+                   segments,
                    args
         )
             .get_result();
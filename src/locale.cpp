@@ -10,7 +10,7 @@ std::locale locale_ref::get() const
                *m_loc;
 }
 
-char index_grouping(const std::string& grouping, std::size_t idx)
+char index_grouping(std::string_view grouping, std::size_t idx)
 {
     if(grouping.empty()) [[unlikely]]
         return '\0';
@@ -1,50 +1,378 @@
 #include <papilio/print.hpp>
 #include <papilio/os/os.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <papilio/detail/prefix.hpp>
 
 namespace papilio
 {
 namespace detail
 {
-    static void output_impl(
-        std::FILE* file,
-        std::string_view out,
-        bool conv_unicode
-    )
-    {
-        if(conv_unicode)
-            os::output_conv(file, out);
-        else
-            os::output_nonconv(file, out);
-    }
-
     void vprint_impl(
         std::FILE* file,
         std::string_view fmt,
+        const fmt_segment_table& segments,
         format_args_ref args,
-        bool conv_unicode,
         bool newline,
         text_style st
     )
     {
-        std::string out;
+        // Buffers larger than this will be released after printing
+        constexpr std::size_t max_kept_capacity = 64 * 1024;
+
+        thread_local std::string tl_buf;
+        thread_local bool tl_buf_in_use = false;
+
+        // Nested printing, e.g., printing inside a formatter, uses a temporary buffer
+        std::string nested_buf;
+        const bool nested = tl_buf_in_use;
+        std::string& out = nested ? nested_buf : tl_buf;
+
+        struct buffer_guard
         {
-            auto it = std::back_inserter(out);
+            std::string& buf;
+            bool nested;
 
-            st.set(it);
-            out += PAPILIO_NS vformat(fmt, args);
-            st.reset(it);
-        }
+            ~buffer_guard()
+            {
+                if(nested)
+                    return;
+                if(buf.capacity() > max_kept_capacity)
+                    std::string().swap(buf);
+                else
+                    buf.clear();
+                tl_buf_in_use = false;
+            }
+        };
+
+        tl_buf_in_use = true;
+        buffer_guard guard{out, nested};
+
+        auto it = std::back_inserter(out);
+        it = st.set(it);
+        it = detail::vformat_to_impl<char, format_iterator_for<char>, format_context>(
+            it, nullptr, fmt, segments, args
+        );
+        st.reset(it);
         if(newline)
             out.push_back('\n');
 
-        output_impl(file, out, conv_unicode);
+        os::output_conv(file, out);
     }
 } // namespace detail
 
+struct async_sink::impl
+{
+    struct node
+    {
+        std::atomic<node*> next = nullptr;
+        std::string text;
+    };
+
+    // Results are concatenated until the batch reaches this size
+    static constexpr std::size_t max_batch_size = 64 * 1024;
+    // Texts of recycled nodes with larger capacities are released
+    static constexpr std::size_t max_kept_capacity = 4 * 1024;
+    // Max number of recycled nodes kept for reuse
+    static constexpr std::size_t free_ring_size = 256;
+    // Counters updated by different threads are placed on separate cache lines to avoid false sharing
+    static constexpr std::size_t cache_line_size = 64;
+
+    std::FILE* file;
+    std::size_t capacity;
+    overflow_policy policy;
+
+    // Intrusive MPSC queue. Producers exchange the tail, and only the writer thread touches the head,
+    // which is always a node whose result has been consumed.
+    alignas(cache_line_size) std::atomic<node*> tail;
+
+    // Number of accepted results, results linked into the queue, and results written to the file
+    alignas(cache_line_size) std::atomic<std::uint64_t> reserved = 0;
+    alignas(cache_line_size) std::atomic<std::uint64_t> submitted = 0;
+    alignas(cache_line_size) std::atomic<std::uint64_t> written = 0;
+    node* head;
+
+    // SPMC ring of consumed nodes for reuse. Only the writer thread fills the slots and advances free_tail,
+    // and producers claim one node by advancing free_head, so the monotonic counters are free from the ABA problem.
+    std::array<std::atomic<node*>, free_ring_size> free_ring{};
+    alignas(cache_line_size) std::atomic<std::uint64_t> free_head = 0;
+    alignas(cache_line_size) std::atomic<std::uint64_t> free_tail = 0;
+    // Nodes of dropped results pushed by producers. Only the writer takes them, all at once.
+    alignas(cache_line_size) std::atomic<node*> returned_nodes = nullptr;
+
+    alignas(cache_line_size) std::atomic<std::size_t> dropped = 0;
+    std::atomic<bool> stopping = false;
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    std::thread writer;
+
+    impl(std::FILE* file_, std::size_t capacity_, overflow_policy policy_)
+        : file(file_),
+          capacity(capacity_ == 0 ? 1 : capacity_),
+          policy(policy_),
+          tail(new node()),
+          head(tail.load(std::memory_order_relaxed))
+    {
+        writer = std::thread([this]()
+                             { run(); });
+    }
+
+    impl(const impl&) = delete;
+
+    ~impl()
+    {
+        stopping.store(true, std::memory_order_release);
+        submitted.fetch_add(1, std::memory_order_release);
+        submitted.notify_one();
+        writer.join();
+
+        delete_list(head);
+        delete_list(returned_nodes.load(std::memory_order_acquire));
+        const std::uint64_t t = free_tail.load(std::memory_order_relaxed);
+        for(std::uint64_t i = free_head.load(std::memory_order_acquire); i < t; ++i)
+            delete free_ring[i % free_ring_size].load(std::memory_order_relaxed);
+    }
+
+    static void delete_list(node* n) noexcept
+    {
+        while(n)
+            delete std::exchange(n, n->next.load(std::memory_order_relaxed));
+    }
+
+    node* acquire_node()
+    {
+        std::uint64_t h = free_head.load(std::memory_order_acquire);
+        while(h != free_tail.load(std::memory_order_acquire))
+        {
+            // The slot cannot be refilled before free_head moves past it, in which case the exchange fails.
+            node* n = free_ring[h % free_ring_size].load(std::memory_order_relaxed);
+            if(free_head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                return n;
+        }
+
+        return new node();
+    }
+
+    // Returns a node that has not been pushed into the queue
+    void return_node(node* n) noexcept
+    {
+        node* top = returned_nodes.load(std::memory_order_relaxed);
+        do
+        {
+            n->next.store(top, std::memory_order_relaxed);
+        } while(!returned_nodes.compare_exchange_weak(top, n, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Returns false if the result should be dropped.
+    bool acquire_slot()
+    {
+        std::uint64_t r = reserved.load(std::memory_order_relaxed);
+        while(true)
+        {
+            if(policy != overflow_policy::grow)
+            {
+                const std::uint64_t w = written.load(std::memory_order_acquire);
+                if(r - w >= capacity)
+                {
+                    if(policy == overflow_policy::drop)
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+
+                    written.wait(w, std::memory_order_acquire);
+                    r = reserved.load(std::memory_order_relaxed);
+                    continue;
+                }
+            }
+
+            if(reserved.compare_exchange_weak(r, r + 1, std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    void push(node* n) noexcept
+    {
+        node* prev = tail.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+
+        submitted.fetch_add(1, std::memory_order_release);
+        submitted.notify_one();
+    }
+
+    // Consumed nodes of the current batch, which are released together after writing
+    struct recycled_list
+    {
+        node* first = nullptr;
+
+        void add(node* n) noexcept
+        {
+            if(n->text.capacity() > max_kept_capacity)
+                std::string().swap(n->text);
+            else
+                n->text.clear();
+
+            n->next.store(first, std::memory_order_relaxed);
+            first = n;
+        }
+    };
+
+    // Appends the result of the next node to the batch, or returns false if the queue is (temporarily) empty.
+    bool pop_to(std::string& batch, recycled_list& recycled)
+    {
+        node* next = head->next.load(std::memory_order_acquire);
+        if(!next)
+            return false;
+
+        recycled.add(std::exchange(head, next));
+        batch.append(next->text);
+
+        return true;
+    }
+
+    // Refills the ring with the recycled nodes. Nodes that do not fit are deleted.
+    void release_nodes(recycled_list& recycled) noexcept
+    {
+        node* n = returned_nodes.exchange(nullptr, std::memory_order_acquire);
+        while(n)
+            recycled.add(std::exchange(n, n->next.load(std::memory_order_relaxed)));
+
+        std::uint64_t t = free_tail.load(std::memory_order_relaxed);
+        const std::uint64_t h = free_head.load(std::memory_order_acquire);
+        while(recycled.first && t - h < free_ring_size)
+        {
+            node* next = recycled.first->next.load(std::memory_order_relaxed);
+            recycled.first->next.store(nullptr, std::memory_order_relaxed);
+            free_ring[t % free_ring_size].store(recycled.first, std::memory_order_relaxed);
+            recycled.first = next;
+            ++t;
+        }
+        free_tail.store(t, std::memory_order_release);
+
+        delete_list(std::exchange(recycled.first, nullptr));
+    }
+
+    void run()
+    {
+        std::string batch;
+        while(true)
+        {
+            const std::uint64_t s = submitted.load(std::memory_order_acquire);
+
+            std::uint64_t count = 0;
+            recycled_list recycled;
+            batch.clear();
+            while(batch.size() < max_batch_size && pop_to(batch, recycled))
+                ++count;
+
+            if(count != 0)
+            {
+                write(batch);
+                release_nodes(recycled);
+                written.fetch_add(count, std::memory_order_release);
+                written.notify_all();
+                continue;
+            }
+
+            // Producers have finished before the destructor, so an empty queue means all results are written.
+            if(stopping.load(std::memory_order_acquire))
+                break;
+
+            submitted.wait(s, std::memory_order_acquire);
+        }
+    }
+
+    void write(std::string_view batch) noexcept
+    {
+        if(batch.empty())
+            return;
+
+        try
+        {
+            os::output_conv(file, batch);
+        }
+        catch(...)
+        {
+            std::lock_guard lock(error_mutex);
+            if(!error)
+                error = std::current_exception();
+        }
+    }
+};
+
+async_sink::async_sink(std::FILE* file, std::size_t capacity, overflow_policy policy)
+    : m_impl(std::make_unique<impl>(file, capacity, policy)) {}
+
+async_sink::~async_sink() = default;
+
+void async_sink::flush()
+{
+    const std::uint64_t target = m_impl->reserved.load(std::memory_order_acquire);
+    std::uint64_t w = m_impl->written.load(std::memory_order_acquire);
+    while(w < target)
+    {
+        m_impl->written.wait(w, std::memory_order_acquire);
+        w = m_impl->written.load(std::memory_order_acquire);
+    }
+
+    std::exception_ptr err;
+    {
+        std::lock_guard lock(m_impl->error_mutex);
+        err = std::exchange(m_impl->error, nullptr);
+    }
+    if(err)
+        std::rethrow_exception(err);
+}
+
+std::size_t async_sink::dropped() const noexcept
+{
+    return m_impl->dropped.load(std::memory_order_relaxed);
+}
+
+void async_sink::vprint(
+    std::string_view fmt,
+    const detail::fmt_segment_table& segments,
+    format_args_ref args,
+    bool newline
+)
+{
+    // Take the node before the slot, so no slot is left unused if the allocation fails
+    impl::node* n = m_impl->acquire_node();
+    if(!m_impl->acquire_slot())
+    {
+        m_impl->return_node(n);
+        return;
+    }
+
+    try
+    {
+        detail::vformat_to_impl<char, format_iterator_for<char>, format_context>(
+            std::back_inserter(n->text), nullptr, fmt, segments, args
+        );
+        if(newline)
+            n->text.push_back('\n');
+    }
+    catch(...)
+    {
+        // The slot has been taken, so an empty result is still enqueued to keep the counters consistent.
+        n->text.clear();
+        m_impl->push(n);
+        throw;
+    }
+
+    m_impl->push(n);
+}
+
 void println(std::FILE* file)
 {
-    detail::output_impl(file, "\n", os::is_terminal(file));
+    os::output_conv(file, "\n");
 }
 
 void println()
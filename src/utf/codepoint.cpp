@@ -1,5 +1,6 @@
 #include <papilio/utf/codepoint.hpp>
 #include <iostream>
+#include <cstring>
 #include <papilio/detail/prefix.hpp>
 
 namespace papilio::utf
@@ -65,6 +66,188 @@ auto decoder<wchar_t>::from_codepoint(codepoint cp) -> from_codepoint_result
     return result;
 }
 
+namespace detail
+{
+    // Stops after the width reaches max_width
+    static std::size_t estimate_width_u8(const std::uint8_t* str, std::size_t size, std::size_t max_width)
+    {
+        constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080u;
+
+        std::size_t width = 0;
+        std::size_t i = 0;
+        while(i < size && width < max_width)
+        {
+            // ASCII blocks of 16 bytes
+            while(size - i >= 16 && width < max_width)
+            {
+                std::uint64_t block[2];
+                std::memcpy(block, str + i, sizeof(block));
+                if(((block[0] | block[1]) & high_bits) != 0)
+                    break;
+
+                width += 16;
+                i += 16;
+            }
+            if(i == size)
+                break;
+
+            const std::uint8_t lead = str[i];
+            const std::size_t remaining = size - i;
+            if(lead < 0x80 || !utf::is_leading_byte(lead) || lead >= 0xF8)
+            {
+                ++width;
+                ++i;
+                continue;
+            }
+
+            const std::uint8_t len = utf::byte_count(lead);
+            if(len > remaining) [[unlikely]]
+            {
+                ++width;
+                break;
+            }
+
+            // Code points encoded in 2 bytes are all narrow
+            if(len == 2)
+            {
+                ++width;
+                i += 2;
+                continue;
+            }
+
+            char32_t ch;
+            if(len == 3)
+            {
+                ch = (char32_t(lead & 0b0000'1111) << 12) |
+                     (char32_t(str[i + 1] & 0b0011'1111) << 6) |
+                     char32_t(str[i + 2] & 0b0011'1111);
+            }
+            else
+            {
+                ch = (char32_t(lead & 0b0000'0111) << 18) |
+                     (char32_t(str[i + 1] & 0b0011'1111) << 12) |
+                     (char32_t(str[i + 2] & 0b0011'1111) << 6) |
+                     char32_t(str[i + 3] & 0b0011'1111);
+            }
+
+            width += utf::estimate_width(ch);
+            i += len;
+        }
+
+        return width;
+    }
+
+    static std::size_t estimate_width_u16(std::u16string_view str, std::size_t max_width)
+    {
+        std::size_t width = 0;
+        for(std::size_t i = 0; i < str.size() && width < max_width;)
+        {
+            const char16_t ch = str[i];
+            if(ch < width_table::first_wide) [[likely]]
+            {
+                ++width;
+                ++i;
+            }
+            else if(utf::is_high_surrogate(ch))
+            {
+                auto [ch32, processed_size] = decoder<char16_t>::to_char32_t(str.substr(i));
+                width += utf::estimate_width(ch32);
+                i += processed_size;
+            }
+            else
+            {
+                width += utf::estimate_width(ch);
+                ++i;
+            }
+        }
+
+        return width;
+    }
+
+    static std::size_t estimate_width_u32(std::u32string_view str, std::size_t max_width) noexcept
+    {
+        std::size_t width = 0;
+        for(std::size_t i = 0; i < str.size() && width < max_width; ++i)
+            width += utf::estimate_width(str[i]);
+
+        return width;
+    }
+
+    static std::size_t estimate_width_wide(std::wstring_view str, std::size_t max_width)
+    {
+        if constexpr(sizeof(wchar_t) == sizeof(char16_t))
+        {
+            return estimate_width_u16(
+                std::u16string_view(reinterpret_cast<const char16_t*>(str.data()), str.size()),
+                max_width
+            );
+        }
+        else
+        {
+            return estimate_width_u32(
+                std::u32string_view(reinterpret_cast<const char32_t*>(str.data()), str.size()),
+                max_width
+            );
+        }
+    }
+
+    constexpr std::size_t no_max_width = static_cast<std::size_t>(-1);
+} // namespace detail
+
+std::size_t estimate_width(std::string_view str)
+{
+    return utf::estimate_width(str, detail::no_max_width);
+}
+
+std::size_t estimate_width(std::u8string_view str)
+{
+    return utf::estimate_width(str, detail::no_max_width);
+}
+
+std::size_t estimate_width(std::u16string_view str)
+{
+    return detail::estimate_width_u16(str, detail::no_max_width);
+}
+
+std::size_t estimate_width(std::u32string_view str) noexcept
+{
+    return detail::estimate_width_u32(str, detail::no_max_width);
+}
+
+std::size_t estimate_width(std::wstring_view str)
+{
+    return detail::estimate_width_wide(str, detail::no_max_width);
+}
+
+std::size_t estimate_width(std::string_view str, std::size_t max_width)
+{
+    return detail::estimate_width_u8(
+        reinterpret_cast<const std::uint8_t*>(str.data()), str.size(), max_width
+    );
+}
+
+std::size_t estimate_width(std::u8string_view str, std::size_t max_width)
+{
+    return detail::estimate_width_u8(
+        reinterpret_cast<const std::uint8_t*>(str.data()), str.size(), max_width
+    );
+}
+
+std::size_t estimate_width(std::u16string_view str, std::size_t max_width)
+{
+    return detail::estimate_width_u16(str, max_width);
+}
+
+std::size_t estimate_width(std::u32string_view str, std::size_t max_width) noexcept
+{
+    return detail::estimate_width_u32(str, max_width);
+}
+
+std::size_t estimate_width(std::wstring_view str, std::size_t max_width)
+{
+    return detail::estimate_width_wide(str, max_width);
+}
+
 std::ostream& operator<<(std::ostream& os, codepoint cp)
 {
     os.write(cp.data(), cp.size_bytes());
@@ -32,6 +32,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u8string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char8_t>>& args
     )
     {
@@ -42,6 +43,7 @@ namespace detail
                    iter_t(),
                    loc,
                    fmt,
+                   segments,
                    args
         )
             .get_result();
@@ -50,6 +52,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u16string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char16_t>>& args
     )
     {
@@ -60,6 +63,7 @@ namespace detail
                    iter_t(),
                    loc,
                    fmt,
+                   segments,
                    args
         )
             .get_result();
@@ -68,6 +72,7 @@ namespace detail
     std::size_t formatted_size_impl(
         locale_ref loc,
         std::u32string_view fmt,
+        const fmt_segment_table& segments,
         const basic_format_args_ref<fmt_size_ctx_type<char32_t>>& args
     )
     {
@@ -78,6 +83,7 @@ namespace detail
                    iter_t(),
                    loc,
                    fmt,
+                   segments,
                    args
         )
             .get_result();
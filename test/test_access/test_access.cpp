@@ -76,6 +76,79 @@ TEST(attribute_name, compare)
     EXPECT_NE("{name}", attr);
 }
 
+TEST(attribute_name, id)
+{
+    using namespace papilio;
+
+    EXPECT_EQ(attribute_name("size").id(), attribute_name("size").id());
+    EXPECT_EQ(attribute_name("size").id(), wattribute_name(L"size").id());
+    EXPECT_NE(attribute_name("size").id(), attribute_name("length").id());
+}
+
+namespace test_access
+{
+// Formats the id of any attribute name
+struct id_probe
+{};
+} // namespace test_access
+
+namespace papilio
+{
+template <typename Context>
+struct accessor<test_access::id_probe, Context>
+{
+    using char_type = typename Context::char_type;
+    using format_arg_type = basic_format_arg<Context>;
+    using attribute_name_type = basic_attribute_name<char_type>;
+
+    static format_arg_type attribute(const test_access::id_probe&, const attribute_name_type& attr)
+    {
+        return static_cast<std::size_t>(attr.id());
+    }
+};
+} // namespace papilio
+
+TEST(attribute_name, id_from_parser)
+{
+    using namespace papilio;
+
+    const test_access::id_probe probe;
+
+    EXPECT_EQ(
+        PAPILIO_NS format("{0.size}", probe),
+        PAPILIO_NS format("{}", attribute_name("size").id())
+    );
+    EXPECT_EQ(
+        PAPILIO_NS format(L"{0.size}", probe),
+        PAPILIO_NS format(L"{}", attribute_name("size").id())
+    );
+    EXPECT_EQ(
+        PAPILIO_NS format("{0.\u540d\u5b57}", probe),
+        PAPILIO_NS format("{}", attribute_name("\u540d\u5b57").id())
+    );
+    EXPECT_EQ(
+        PAPILIO_NS format(L"{0.\u540d\u5b57}", probe),
+        PAPILIO_NS format(L"{}", wattribute_name(L"\u540d\u5b57").id())
+    );
+}
+
+TEST(attribute_table, find)
+{
+    using namespace papilio;
+
+    static constexpr attribute_table table{"size", "length", "value"};
+    static_assert(table.size() == 3);
+    static_assert(table.index_of("length") == 1);
+    static_assert(table[2] == "value");
+
+    EXPECT_EQ(table.find(attribute_name("size")), 0);
+    EXPECT_EQ(table.find(attribute_name("length")), 1);
+    EXPECT_EQ(table.find(attribute_name("value")), 2);
+    EXPECT_EQ(table.find(wattribute_name(L"value")), 2);
+    EXPECT_EQ(table.find(attribute_name("values")), table.npos);
+    EXPECT_EQ(table.find(attribute_name("")), table.npos);
+}
+
 TEST(accessor, string)
 {
     using namespace papilio;
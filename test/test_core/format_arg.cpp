@@ -176,6 +176,67 @@ TEST(format_arg, swap)
     }
 }
 
+TEST(format_arg, tag)
+{
+    using namespace papilio;
+
+    static_assert(sizeof(format_arg) <= 48);
+
+    EXPECT_EQ(format_arg().tag(), format_arg::type_tag::none);
+    EXPECT_EQ(format_arg(true).tag(), format_arg::type_tag::bool_type);
+    EXPECT_EQ(format_arg(1).tag(), format_arg::type_tag::int_type);
+    EXPECT_EQ(format_arg(1u).tag(), format_arg::type_tag::uint_type);
+    EXPECT_EQ(format_arg(1.0).tag(), format_arg::type_tag::double_type);
+    EXPECT_EQ(format_arg("str").tag(), format_arg::type_tag::string_type);
+    EXPECT_EQ(format_arg(nullptr).tag(), format_arg::type_tag::pointer_type);
+    EXPECT_EQ(format_arg(typeid(int)).tag(), format_arg::type_tag::handle_type);
+
+    {
+        format_arg fmt_arg(1.5L);
+        EXPECT_TRUE(fmt_arg.holds<long double>());
+        EXPECT_EQ(fmt_arg.tag(), format_arg::type_tag::long_double_type);
+        EXPECT_EQ(get<long double>(fmt_arg), 1.5L);
+        EXPECT_THROW((void)get<double>(fmt_arg), std::bad_variant_access);
+
+        format_arg copied(fmt_arg);
+        EXPECT_EQ(get<long double>(copied), 1.5L);
+
+        // Visitors get references into the argument for all of the types
+        const void* addr = fmt_arg.visit(
+            [](const auto& v) -> const void*
+            {
+                return &v;
+            }
+        );
+        EXPECT_EQ(addr, &get<long double>(fmt_arg));
+    }
+
+    {
+        format_arg fmt_arg(independent, std::string("long string without small string optimization"));
+        EXPECT_TRUE(fmt_arg.has_ownership());
+
+        format_arg moved(std::move(fmt_arg));
+        EXPECT_TRUE(fmt_arg.empty());
+        EXPECT_TRUE(moved.has_ownership());
+        EXPECT_EQ(get<std::string>(moved), "long string without small string optimization");
+
+        // Copying only creates a view to the string
+        format_arg copied(moved);
+        EXPECT_FALSE(copied.has_ownership());
+        EXPECT_EQ(get<std::string>(copied), "long string without small string optimization");
+
+        copied = format_arg(1);
+        EXPECT_EQ(get<int>(copied), 1);
+
+        auto var = std::move(moved).to_variant();
+        EXPECT_TRUE(moved.empty());
+        ASSERT_TRUE(std::holds_alternative<utf::string_container>(var));
+        EXPECT_EQ(std::get<utf::string_container>(var), "long string without small string optimization");
+        // The string is moved instead of copied as a view
+        EXPECT_TRUE(std::get<utf::string_container>(var).has_ownership());
+    }
+}
+
 TEST(format_arg, access)
 {
     using namespace papilio;
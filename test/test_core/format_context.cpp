@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <vector>
 #include <papilio/core.hpp>
 #include <papilio/format.hpp>
 #include "test_core.hpp"
@@ -47,6 +48,39 @@ TYPED_TEST(format_context_suite, append)
     }
 }
 
+TYPED_TEST(format_context_suite, bulk_output)
+{
+    using namespace papilio;
+
+    using context_type = typename TestFixture::context_type;
+    static_assert(format_context_traits<context_type>::bulk_output());
+
+    using ptr_context_type = basic_format_context<TypeParam*, TypeParam>;
+    static_assert(!format_context_traits<ptr_context_type>::bulk_output());
+
+    using buf_context_type = basic_format_context<
+        typename basic_memory_buffer<TypeParam>::appender,
+        TypeParam>;
+    static_assert(format_context_traits<buf_context_type>::bulk_output());
+
+    using vec_context_type = basic_format_context<
+        std::back_insert_iterator<std::vector<TypeParam>>,
+        TypeParam>;
+    using context_t = format_context_traits<vec_context_type>;
+    static_assert(context_t::bulk_output());
+
+    std::vector<TypeParam> result;
+    vec_context_type ctx(std::back_inserter(result), empty_format_args_for<vec_context_type>());
+
+    context_t::append(ctx, PAPILIO_TSTRING_VIEW(TypeParam, "12"));
+    context_t::append(ctx, '3', 2);
+    context_t::append(ctx, U'\u00c4', 2);
+    context_t::append(ctx, U'\u00c4', 0);
+
+    const auto expected_str = PAPILIO_TSTRING_ARRAY(TypeParam, "1233\u00c4\u00c4");
+    EXPECT_EQ(std::basic_string<TypeParam>(result.begin(), result.end()), expected_str);
+}
+
 TYPED_TEST(format_context_suite, format_to)
 {
     using namespace papilio;
@@ -367,7 +367,8 @@ TEST(interpreter, exception)
     using enum script_error_code;
     using test_script_interpreter::get_err;
 
-    EXPECT_EQ(get_err("{").error_code(), end_of_string);
+    // Unenclosed braces of string literals will be reported at compile time
+    EXPECT_EQ(get_err(std::string_view("{")).error_code(), end_of_string);
     EXPECT_EQ(get_err("{$ 'str'}").error_code(), invalid_condition);
     EXPECT_EQ(get_err("{$ 'str'?}").error_code(), invalid_string);
     EXPECT_EQ(get_err("{$ 'str'? 'incomplete\\").error_code(), invalid_string);
@@ -415,3 +416,50 @@ TEST(interpreter, debug)
     PAPILIO_TEST_INTERPRETER_DEBUG("{$ 'str'?}", invalid_string, 9);
     PAPILIO_TEST_INTERPRETER_DEBUG("{$ 'str'==={0}?'s'}", invalid_condition, 10);
 }
+
+TEST(interpreter, script_cache)
+{
+    using namespace papilio;
+
+    ASSERT_TRUE(script_base::script_cache_enabled());
+
+    auto format_both = [](std::string_view fmt, auto&&... args) -> std::string
+    {
+        script_base::enable_script_cache(false);
+        std::string interpreted = PAPILIO_NS vformat(fmt, PAPILIO_NS make_format_args(args...));
+        script_base::enable_script_cache(true);
+
+        // The first call compiles the script and the second one uses the cached result
+        for(int i = 0; i < 2; ++i)
+        {
+            std::string cached = PAPILIO_NS vformat(fmt, PAPILIO_NS make_format_args(args...));
+            EXPECT_EQ(cached, interpreted) << "fmt = " << fmt;
+        }
+
+        return interpreted;
+    };
+
+    EXPECT_EQ(format_both("{$ {0} == 1 ? 'one' : $ {0} > 1 ? 'many' : 'none'}", 0), "none");
+    EXPECT_EQ(format_both("{$ {0} == 1 ? 'one' : $ {0} > 1 ? 'many' : 'none'}", 1), "one");
+    EXPECT_EQ(format_both("{$ {0} == 1 ? 'one' : $ {0} > 1 ? 'many' : 'none'}", 2), "many");
+    EXPECT_EQ(format_both("{$ !{} ? 'empty' : {:>4}}", 0, 42), "empty");
+    EXPECT_EQ(format_both("{$ !{} ? 'empty' : {:>4}}", 1, 42), "  42");
+    EXPECT_EQ(format_both("{$ {} ? 'a\\'b\\n' : 'c'}!", true), "a'b\n!");
+    EXPECT_EQ(format_both("{$ {0} != 'str' ? {1:.1f}}", "text", 3.14), "3.1");
+    EXPECT_EQ(format_both("{$ {0} >= 2.5 ? 'big'}{$ {0} < 2.5 ? 'small'}", 2.0), "small");
+
+    // The script followed by invalid characters
+    script_base::enable_script_cache(true);
+    EXPECT_THROW((void)PAPILIO_NS vformat("{$ {} ? 'a' : 'b' 'c'}", PAPILIO_NS make_format_args(true)), script_base::error);
+    EXPECT_THROW((void)PAPILIO_NS vformat("{$ {} ? 'a' : 'b' 'c'}", PAPILIO_NS make_format_args(true)), script_base::error);
+
+    // More scripts than the capacity of the cache, which are interpreted after the cache is full
+    for(int round = 0; round < 2; ++round)
+    {
+        for(int i = 0; i < 1100; ++i)
+        {
+            const std::string fmt = PAPILIO_NS format("{{$ {{0}} == {} ? 'hit' : 'miss'}}", i);
+            EXPECT_EQ(PAPILIO_NS vformat(fmt, PAPILIO_NS make_format_args(i)), "hit") << "fmt = " << fmt;
+        }
+    }
+}
@@ -68,6 +68,101 @@ TEST(format_args, dynamic)
     }
 }
 
+TEST(format_args, dynamic_many_named)
+{
+    using namespace papilio;
+
+    std::vector<std::string> names;
+    for(int i = 0; i < 40; ++i)
+        names.push_back("field_" + std::to_string(i));
+
+    dynamic_format_args args;
+    for(int i = 0; i < 40; ++i)
+        args.emplace(arg(std::string_view(names[i]), i));
+
+    EXPECT_EQ(args.named_size(), 40);
+    for(int i = 0; i < 40; ++i)
+    {
+        EXPECT_TRUE(args.contains(names[i]));
+        EXPECT_EQ(get<int>(args[names[i]]), i);
+    }
+
+    {
+        // In insertion order
+        int i = 0;
+        EXPECT_EQ(args.named().size(), 40);
+        for(const auto& [name, val] : args.named())
+        {
+            EXPECT_EQ(name, names[i]);
+            EXPECT_EQ(get<int>(val), i);
+            ++i;
+        }
+        EXPECT_EQ(i, 40);
+    }
+    EXPECT_FALSE(args.contains("field_40"));
+    EXPECT_FALSE(args.contains("field"));
+    EXPECT_THROW((void)args.get("field_40"), std::out_of_range);
+
+    // The first one wins
+    args.emplace("field_7"_a = -1);
+    EXPECT_EQ(args.named_size(), 40);
+    EXPECT_EQ(get<int>(args["field_7"]), 7);
+
+    // Names are copied into the arguments
+    names.clear();
+    dynamic_format_args moved(std::move(args));
+    EXPECT_EQ(get<int>(moved["field_0"]), 0);
+    EXPECT_EQ(get<int>(moved["field_39"]), 39);
+
+    moved.clear();
+    EXPECT_EQ(moved.named_size(), 0);
+    EXPECT_FALSE(moved.contains("field_0"));
+
+    moved.emplace("field_0"_a = 100);
+    EXPECT_EQ(get<int>(moved["field_0"]), 100);
+
+    // The view sees the arguments added after the first one
+    moved.emplace("a"_a = 1);
+    EXPECT_EQ(moved.named().size(), 2);
+    EXPECT_EQ((*moved.named().begin()).first, "field_0");
+    static_assert(noexcept(std::as_const(moved).named()));
+
+    // Ignored duplicates are not added
+    moved.emplace("a"_a = 2);
+    EXPECT_EQ(moved.named().size(), 2);
+    EXPECT_EQ(get<int>(moved["a"]), 1);
+}
+
+TEST(format_args, dynamic_owning_named)
+{
+    using namespace papilio;
+
+    // More owning arguments than the inline storage of named arguments
+    dynamic_format_args args;
+    for(int i = 0; i < 10; ++i)
+    {
+        const std::string name = "s" + std::to_string(i);
+        args.emplace(arg(
+            std::string_view(name),
+            format_arg(independent, "long string without small string optimization " + std::to_string(i))
+        ));
+    }
+
+    int i = 0;
+    for(const auto& [name, val] : args.named())
+    {
+        EXPECT_EQ(name, "s" + std::to_string(i));
+        EXPECT_EQ(get<utf::string_container>(val), "long string without small string optimization " + std::to_string(i));
+        ++i;
+    }
+    EXPECT_EQ(i, 10);
+
+    EXPECT_EQ(
+        PAPILIO_NS vformat("{s0}|{s9}", args),
+        "long string without small string optimization 0|long string without small string optimization 9"
+    );
+}
+
 TEST(format_args, static)
 {
     using namespace papilio;
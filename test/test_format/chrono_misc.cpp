@@ -104,8 +104,83 @@ TEST(chrono_formatter, misc)
     }
 
     // Error handling
+    // Malformed string literals are rejected at compile time, so runtime strings are used here.
     {
-        EXPECT_THROW((void)PAPILIO_NS format("{:{{}", 2024y), format_error);
-        EXPECT_THROW((void)PAPILIO_NS format("{:}}", 2024y), format_error);
+        EXPECT_THROW((void)PAPILIO_NS format(std::string_view("{:{{}"), 2024y), format_error);
+        EXPECT_THROW((void)PAPILIO_NS format(std::string_view("{:}}"), 2024y), format_error);
     }
 }
+
+TEST(chrono_formatter, numeric_spec)
+{
+    using namespace std::chrono_literals;
+    using namespace papilio;
+
+    // Numeric specifications are written directly,
+    // while the "L" option forces the result to be produced by the stream-based implementation.
+    const auto tp = std::chrono::sys_days(2024y / 3 / 5) + 7h + 8min + 9s + 12ms;
+    {
+        EXPECT_EQ(PAPILIO_NS format("{:%F %T}", tp), "2024-03-05 07:08:09.012");
+        EXPECT_EQ(PAPILIO_NS format("{:%Y-%m-%dT%H:%M:%S%z}", tp), "2024-03-05T07:08:09.012+0000");
+        EXPECT_EQ(PAPILIO_NS format("{:%e|%j|%y|%D|%R}", tp), " 5|065|24|03/05/24|07:08");
+        EXPECT_EQ(PAPILIO_NS format("{:*^11%H:%M}", tp), "***07:08***");
+        EXPECT_EQ(PAPILIO_NS format(L"{:%F %T}", tp), L"2024-03-05 07:08:09.012");
+
+        for(std::string_view spec : {"%F %T", "%Y-%m-%dT%H:%M:%S%z", "%e|%j|%y|%D|%R|%n%t%%"})
+        {
+            EXPECT_EQ(
+                PAPILIO_NS format(std::string_view("{:" + std::string(spec) + "}"), tp),
+                PAPILIO_NS format(std::string_view("{:L" + std::string(spec) + "}"), tp)
+            );
+        }
+    }
+
+    // Durations and hh_mm_ss
+    {
+        EXPECT_EQ(PAPILIO_NS format("{:%T}", 1234ms), "00:00:01.234");
+        EXPECT_EQ(PAPILIO_NS format("{:%T}", -1234ms), PAPILIO_NS format("{:L%T}", -1234ms));
+        EXPECT_EQ(PAPILIO_NS format("{:%H:%M:%S}", std::chrono::hh_mm_ss(3723456ms)), "01:02:03.456");
+    }
+
+    // std::tm
+    {
+        std::tm t = papilio_test::create_tm_epoch();
+        EXPECT_EQ(PAPILIO_NS format("{:%F %T}", t), "1970-01-01 00:00:00");
+        EXPECT_EQ(PAPILIO_NS format("{:%F %T}", t), PAPILIO_NS format("{:L%F %T}", t));
+        EXPECT_EQ(PAPILIO_NS format("{:%e|%j|%D}", t), PAPILIO_NS format("{:L%e|%j|%D}", t));
+    }
+}
+
+TEST(chrono_formatter, timestamp_cache)
+{
+    using namespace std::chrono_literals;
+    using namespace papilio;
+
+    const std::chrono::sys_time<std::chrono::milliseconds> start = std::chrono::sys_days(2024y / 12 / 31) + 23h + 59min + 58s;
+
+    auto format_both = [](std::string_view fmt, const auto& tp)
+    {
+        chrono::enable_timestamp_cache(false);
+        std::string expected = PAPILIO_NS format(fmt, tp);
+        chrono::enable_timestamp_cache(true);
+        std::string result = PAPILIO_NS format(fmt, tp);
+
+        EXPECT_EQ(result, expected) << "fmt = " << fmt;
+        return result;
+    };
+
+    for(auto tp = start; tp < start + 3s; tp += 300ms)
+    {
+        for(std::string_view fmt : {"{:%F %T}", "{:%FT%TZ}", "{:%T %z}", "{:%Y-%m-%d %H:%M}", "{:%T|%T}", "{:*^30%F %T}"})
+        {
+            format_both(fmt, tp);
+            format_both(fmt, std::chrono::floor<std::chrono::seconds>(tp));
+        }
+    }
+
+    EXPECT_EQ(format_both("{:%F %T}", start + 2s + 345ms), "2025-01-01 00:00:00.345");
+    EXPECT_EQ(format_both("{:%F %T}", start + 2s + 678ms), "2025-01-01 00:00:00.678");
+    EXPECT_EQ(format_both("{:%T}", std::chrono::floor<std::chrono::seconds>(start) + 1s), "23:59:59");
+
+    EXPECT_TRUE(chrono::timestamp_cache_enabled());
+}
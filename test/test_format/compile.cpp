@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <papilio/format.hpp>
+#include <papilio/compile.hpp>
+#include "test_format.hpp"
+#include <papilio_test/setup.hpp>
+
+TYPED_TEST(format_suite, compiled_plain_text)
+{
+    using namespace papilio;
+
+    using string_view_type = typename TestFixture::string_view_type;
+
+    {
+        const basic_compiled_format<TypeParam> fmt(string_view_type{});
+        EXPECT_EQ(PAPILIO_NS format(fmt), string_view_type());
+    }
+
+    {
+        const basic_compiled_format<TypeParam> fmt(PAPILIO_TSTRING_VIEW(TypeParam, "plain text"));
+        EXPECT_EQ(PAPILIO_NS format(fmt), PAPILIO_TSTRING_VIEW(TypeParam, "plain text"));
+    }
+
+    {
+        const basic_compiled_format<TypeParam> fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{{plain text}}"));
+        EXPECT_EQ(PAPILIO_NS format(fmt), PAPILIO_TSTRING_VIEW(TypeParam, "{plain text}"));
+    }
+}
+
+TYPED_TEST(format_suite, compiled_replacement_field)
+{
+    using namespace papilio;
+
+    using string_view_type = typename TestFixture::string_view_type;
+
+#define PAPILIO_CHECK_COMPILED(fmt, expected, ...)                            \
+    do                                                                        \
+    {                                                                         \
+        const string_view_type fmt_sv = PAPILIO_TSTRING_VIEW(TypeParam, fmt); \
+        const basic_compiled_format<TypeParam> compiled(fmt_sv);              \
+        EXPECT_EQ(                                                            \
+            PAPILIO_NS format(compiled, __VA_ARGS__),                         \
+            PAPILIO_NS format(fmt_sv, __VA_ARGS__)                            \
+        ) << "fmt = "                                                         \
+          << std::quoted(fmt);                                                \
+        EXPECT_EQ(                                                            \
+            PAPILIO_NS format(compiled, __VA_ARGS__),                         \
+            PAPILIO_TSTRING_VIEW(TypeParam, expected)                         \
+        ) << "fmt = "                                                         \
+          << std::quoted(fmt);                                                \
+    } while(0)
+
+    PAPILIO_CHECK_COMPILED("{}", "182375", 182375);
+    PAPILIO_CHECK_COMPILED("{} {}", "1 2", 1, 2);
+    PAPILIO_CHECK_COMPILED("{1} {0}", "2 1", 1, 2);
+    PAPILIO_CHECK_COMPILED("value = {:>8}", "value =       42", 42);
+    PAPILIO_CHECK_COMPILED("{:#x}", "0xff", 255);
+    PAPILIO_CHECK_COMPILED("{:+08d}", "+0000042", 42);
+    PAPILIO_CHECK_COMPILED("{:c}", "A", 65);
+    PAPILIO_CHECK_COMPILED("{:.3f}", "3.142", 3.14159);
+    PAPILIO_CHECK_COMPILED("{:*^7}", "**abc**", PAPILIO_TSTRING_VIEW(TypeParam, "abc"));
+    PAPILIO_CHECK_COMPILED("{:?}", "'a'", TypeParam('a'));
+    PAPILIO_CHECK_COMPILED("{}", "true", true);
+    PAPILIO_CHECK_COMPILED("{:{}}", "  1", 1, 3);
+    PAPILIO_CHECK_COMPILED("{{{}}}", "{1}", 1);
+    PAPILIO_CHECK_COMPILED("{0.length}", "5", PAPILIO_TSTRING_VIEW(TypeParam, "hello"));
+    PAPILIO_CHECK_COMPILED("{0.length:>3}", "  5", PAPILIO_TSTRING_VIEW(TypeParam, "hello"));
+
+#undef PAPILIO_CHECK_COMPILED
+
+    {
+        const basic_compiled_format<TypeParam> fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{name}: {value:.1f}"));
+        EXPECT_EQ(
+            PAPILIO_NS format(
+                fmt,
+                PAPILIO_NS arg(PAPILIO_TSTRING_VIEW(TypeParam, "name"), 1),
+                PAPILIO_NS arg(PAPILIO_TSTRING_VIEW(TypeParam, "value"), 1.25)
+            ),
+            PAPILIO_TSTRING_VIEW(TypeParam, "1: 1.2")
+        );
+    }
+}
+
+TYPED_TEST(format_suite, compiled_script)
+{
+    using namespace papilio;
+
+    const basic_compiled_format<TypeParam> fmt(
+        PAPILIO_TSTRING_VIEW(TypeParam, "{} warning{$ {0} > 1 ? 's'}.")
+    );
+
+    EXPECT_EQ(PAPILIO_NS format(fmt, 1), PAPILIO_TSTRING_VIEW(TypeParam, "1 warning."));
+    EXPECT_EQ(PAPILIO_NS format(fmt, 2), PAPILIO_TSTRING_VIEW(TypeParam, "2 warnings."));
+
+    const basic_compiled_format<TypeParam> branch_fmt(
+        PAPILIO_TSTRING_VIEW(TypeParam, "{$ {0} == 0 ? 'zero' : $ {0} < 0 ? '{neg}' : {0:+}}!")
+    );
+
+    EXPECT_EQ(PAPILIO_NS format(branch_fmt, 0), PAPILIO_TSTRING_VIEW(TypeParam, "zero!"));
+    EXPECT_EQ(PAPILIO_NS format(branch_fmt, -1), PAPILIO_TSTRING_VIEW(TypeParam, "{neg}!"));
+    EXPECT_EQ(PAPILIO_NS format(branch_fmt, 1), PAPILIO_TSTRING_VIEW(TypeParam, "+1!"));
+}
+
+TYPED_TEST(format_suite, compiled_format_to)
+{
+    using namespace papilio;
+
+    const basic_compiled_format<TypeParam> fmt(PAPILIO_TSTRING_VIEW(TypeParam, "[{:>4}]"));
+
+    std::vector<TypeParam> result;
+    for(int i : {1, 22, 333})
+        PAPILIO_NS format_to(std::back_inserter(result), fmt, i);
+
+    EXPECT_EQ(
+        std::basic_string_view<TypeParam>(result.data(), result.size()),
+        PAPILIO_TSTRING_VIEW(TypeParam, "[   1][  22][ 333]")
+    );
+}
+
+TYPED_TEST(format_suite, compiled_exceptions)
+{
+    using namespace papilio;
+
+    using compiled_t = basic_compiled_format<TypeParam>;
+
+    EXPECT_THROW(compiled_t(PAPILIO_TSTRING_VIEW(TypeParam, "{")), format_error);
+    EXPECT_THROW(compiled_t(PAPILIO_TSTRING_VIEW(TypeParam, "}")), format_error);
+    EXPECT_THROW(compiled_t(PAPILIO_TSTRING_VIEW(TypeParam, "{0")), format_error);
+    EXPECT_THROW(compiled_t(PAPILIO_TSTRING_VIEW(TypeParam, "} ")), format_error);
+
+    {
+        const compiled_t fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{:s}"));
+        EXPECT_THROW((void)PAPILIO_NS format(fmt, 1), format_error);
+    }
+
+    {
+        const compiled_t fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{} {0}"));
+        EXPECT_NO_THROW((void)PAPILIO_NS format(fmt, 1));
+    }
+
+    {
+        const compiled_t fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{0} {}"));
+        EXPECT_THROW((void)PAPILIO_NS format(fmt, 1), format_error);
+    }
+
+    {
+        const compiled_t fmt(PAPILIO_TSTRING_VIEW(TypeParam, "{} {}"));
+        EXPECT_THROW((void)PAPILIO_NS format(fmt, 1), std::out_of_range);
+    }
+}
@@ -3,6 +3,8 @@
 #    include <format> // Test ADL-proof
 #endif
 #include <papilio/format.hpp>
+#include <vector>
+#include <charconv>
 #include <random>
 #include "test_format.hpp"
 #include <papilio_test/setup.hpp>
@@ -114,6 +116,37 @@ TYPED_TEST(float_formatter_suite, scientific)
     }
 }
 
+TYPED_TEST(float_formatter_suite, long_output)
+{
+    using namespace papilio;
+
+    // Results longer than the internal buffer on the stack
+    {
+        const TypeParam val = std::numeric_limits<TypeParam>::max();
+
+        char buf[8192];
+        auto result = std::to_chars(buf, buf + std::size(buf), val, std::chars_format::fixed, 6);
+        ASSERT_EQ(result.ec, std::errc());
+        const std::string expected(buf, result.ptr);
+
+        EXPECT_EQ(PAPILIO_NS format("{:f}", val), expected);
+        EXPECT_EQ(PAPILIO_NS format("{:>1f}", val), expected);
+        EXPECT_EQ(PAPILIO_NS format("{:+f}", val), "+" + expected);
+        EXPECT_EQ(PAPILIO_NS format(L"{:f}", val), std::wstring(expected.begin(), expected.end()));
+    }
+
+    {
+        EXPECT_EQ(PAPILIO_NS format("{:.200f}", TypeParam(0)), "0." + std::string(200, '0'));
+        EXPECT_EQ(PAPILIO_NS format("{:.200E}", TypeParam(1)), "1." + std::string(200, '0') + "E+00");
+    }
+
+    {
+        std::vector<char> result;
+        PAPILIO_NS format_to(std::back_inserter(result), "{:F}|{:.2F}", TypeParam(1.5L), std::numeric_limits<TypeParam>::infinity());
+        EXPECT_EQ(std::string_view(result.data(), result.size()), "1.500000|INF");
+    }
+}
+
 TYPED_TEST(float_formatter_suite, hex)
 {
     using namespace papilio;
@@ -228,4 +261,6 @@ TEST(float_formatter, locale)
         EXPECT_EQ(PAPILIO_NS format(loc, L"{:f}", 123456789.123456789), L"123456789.123457");
         EXPECT_EQ(PAPILIO_NS format(loc, L"{:Lf}", 123456789.123456789), L"123.456.78.9,123457");
     }
+
+    EXPECT_EQ(PAPILIO_NS format(std::locale::classic(), "{:Lf}", 123456789.5), "123456789.500000");
 }
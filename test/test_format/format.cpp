@@ -4,8 +4,10 @@
 #endif
 #include <papilio/format.hpp>
 #include <vector>
+#include <limits>
 #include <iostream>
 #include <ranges>
+#include <thread>
 #include "test_format.hpp"
 #include <papilio_test/setup.hpp>
 
@@ -82,6 +84,72 @@ TYPED_TEST(format_suite, format_to)
     }
 }
 
+TYPED_TEST(format_suite, memory_buffer)
+{
+    using namespace papilio;
+
+    using string_view_type = typename TestFixture::string_view_type;
+
+    {
+        basic_memory_buffer<TypeParam> buf;
+        PAPILIO_NS format_to(buf, PAPILIO_TSTRING_ARRAY(TypeParam, "{} + {} = {}"), 1, 2, 3);
+
+        EXPECT_EQ(buf.view(), PAPILIO_TSTRING_VIEW(TypeParam, "1 + 2 = 3"));
+        EXPECT_FALSE(buf.dynamic_allocated());
+
+        // Reuse the buffer
+        buf.clear();
+        PAPILIO_NS format_to(buf, PAPILIO_TSTRING_ARRAY(TypeParam, "{:*^7}"), PAPILIO_TSTRING_VIEW(TypeParam, "abc"));
+        PAPILIO_NS format_to(buf, PAPILIO_TSTRING_ARRAY(TypeParam, "{$ {0} > 1 ? 's'}"), 2);
+        EXPECT_EQ(buf.view(), PAPILIO_TSTRING_VIEW(TypeParam, "**abc**s"));
+        EXPECT_FALSE(buf.dynamic_allocated());
+    }
+
+    {
+        basic_memory_buffer<TypeParam, 4> buf;
+        PAPILIO_NS format_to(buf, PAPILIO_TSTRING_ARRAY(TypeParam, "{:>16}"), 42);
+
+        EXPECT_EQ(buf.size(), 16);
+        EXPECT_EQ(buf.view(), PAPILIO_TSTRING_VIEW(TypeParam, "              42"));
+        EXPECT_TRUE(buf.dynamic_allocated());
+
+        const std::size_t cap = buf.capacity();
+        buf.clear();
+        PAPILIO_NS format_to(buf, PAPILIO_TSTRING_ARRAY(TypeParam, "{:<8}|"), PAPILIO_TSTRING_VIEW(TypeParam, "str"));
+        EXPECT_EQ(buf.str(), PAPILIO_TSTRING_VIEW(TypeParam, "str     |"));
+        EXPECT_EQ(buf.capacity(), cap);
+    }
+
+    {
+        std::locale loc = papilio_test::attach_yes_no<TypeParam>();
+
+        basic_memory_buffer<TypeParam> buf;
+        string_view_type fmt = PAPILIO_TSTRING_VIEW(TypeParam, "{:L}");
+        PAPILIO_NS format_to(buf, loc, fmt, true);
+
+        EXPECT_EQ(buf.view(), papilio_test::yes_no_numpunct<TypeParam>::yes_string);
+    }
+
+    // Appending and inserting the contents of the buffer itself
+    {
+        basic_memory_buffer<TypeParam, 8> buf;
+        buf.append(PAPILIO_TSTRING_VIEW(TypeParam, "abcdefghijklmnopqrst"));
+        ASSERT_TRUE(buf.dynamic_allocated());
+
+        buf.append(buf.view());
+        EXPECT_EQ(buf.view(), PAPILIO_TSTRING_VIEW(TypeParam, "abcdefghijklmnopqrstabcdefghijklmnopqrst"));
+
+        buf.insert(buf.cbegin() + 1, buf.cbegin(), buf.cbegin() + 3);
+        EXPECT_EQ(buf.view().substr(0, 8), PAPILIO_TSTRING_VIEW(TypeParam, "aabcbcde"));
+
+        buf.clear();
+        buf.append(PAPILIO_TSTRING_VIEW(TypeParam, "ace"));
+        buf.insert(buf.cbegin() + 1, 1, TypeParam('b'));
+        buf.insert(buf.cbegin() + 3, 1, TypeParam('d'));
+        EXPECT_EQ(buf.view(), PAPILIO_TSTRING_VIEW(TypeParam, "abcde"));
+    }
+}
+
 TYPED_TEST(format_suite, formatted_size)
 {
     using namespace papilio;
@@ -106,6 +174,30 @@ TYPED_TEST(format_suite, formatted_size)
         string_view_type fmt = PAPILIO_TSTRING_VIEW(TypeParam, "{:L}");
         EXPECT_EQ(PAPILIO_NS formatted_size(loc, fmt, true), 3); // Size of "yes"
     }
+
+    {
+        const string_view_type fmts[] = {
+            PAPILIO_TSTRING_VIEW(TypeParam, "{}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:+}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:#x}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:#B}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:o}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:08}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:*^12}")
+        };
+        const long long vals[] = {0, 7, -42, 65535, std::numeric_limits<long long>::min()};
+
+        for(string_view_type fmt : fmts)
+        {
+            for(long long v : vals)
+            {
+                EXPECT_EQ(
+                    PAPILIO_NS formatted_size(fmt, v),
+                    PAPILIO_NS format(fmt, v).size()
+                );
+            }
+        }
+    }
 }
 
 TYPED_TEST(format_suite, format_to_n)
@@ -169,6 +261,62 @@ TYPED_TEST(format_suite, format_to_n)
         const auto expected_str = PAPILIO_TSTRING_VIEW(TypeParam, "yes!");
         EXPECT_EQ(str, expected_str);
     }
+
+    {
+        const string_type long_str(1024, TypeParam('a'));
+
+        TypeParam buf[8]{};
+        auto result = PAPILIO_NS format_to_n(
+            buf,
+            5,
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:>4}|{}"),
+            long_str,
+            long_str
+        );
+
+        EXPECT_EQ(result.out, buf + 5);
+        EXPECT_EQ(result.size, 5);
+        EXPECT_EQ(string_type(buf), string_type(5, TypeParam('a')));
+    }
+
+    {
+        string_type str{};
+        str.resize(6);
+        auto result = PAPILIO_NS format_to_n(
+            str.begin(),
+            str.size(),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{:*>8}"),
+            PAPILIO_TSTRING_VIEW(TypeParam, "abc")
+        );
+
+        EXPECT_EQ(result.size, 6);
+        EXPECT_EQ(str, PAPILIO_TSTRING_VIEW(TypeParam, "*****a"));
+    }
+
+    {
+        int visited = 0;
+        auto rng = std::views::iota(0, 100000) |
+                   std::views::transform(
+                       [&visited](int v)
+                       {
+                           ++visited;
+                           return v;
+                       }
+                   );
+
+        string_type str{};
+        str.resize(8);
+        auto result = PAPILIO_NS format_to_n(
+            str.begin(),
+            str.size(),
+            PAPILIO_TSTRING_VIEW(TypeParam, "{}"),
+            rng
+        );
+
+        EXPECT_EQ(result.size, 8);
+        EXPECT_EQ(str, PAPILIO_TSTRING_VIEW(TypeParam, "[0, 1, 2"));
+        EXPECT_LT(visited, 10);
+    }
 }
 
 TYPED_TEST(format_suite, exception)
@@ -265,3 +413,96 @@ TYPED_TEST(format_suite, formatted_range)
 
 #endif
 }
+
+namespace test_format
+{
+struct point
+{
+    int x;
+    int y;
+};
+} // namespace test_format
+
+namespace papilio
+{
+template <typename CharT>
+struct formatter<test_format::point, CharT>
+{
+    template <typename ParseContext>
+    auto parse(ParseContext& ctx) -> typename ParseContext::iterator
+    {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const test_format::point& p, FormatContext& ctx) const
+        -> typename FormatContext::iterator
+    {
+        return PAPILIO_NS format_to(ctx.out(), PAPILIO_TSTRING_VIEW(CharT, "({}, {})"), p.x, p.y);
+    }
+};
+} // namespace papilio
+
+TEST(format_capture, format_capture)
+{
+    using namespace papilio;
+
+    {
+        format_capture cap("plain text");
+        EXPECT_EQ(cap.indexed_size(), 0);
+        EXPECT_EQ(cap.named_size(), 0);
+        EXPECT_EQ(cap.format(), "plain text");
+    }
+
+    // Captured values are independent of the original ones
+    {
+        std::string str = "hello";
+        int arr[3] = {1, 2, 3};
+        test_format::point pt{3, 4};
+        std::vector<int> vec{7, 8};
+
+        format_capture cap(
+            "{} {:.2f} {name} {} {} {} {:>3}",
+            str,
+            3.14159,
+            "name"_a = std::string("world"),
+            pt,
+            arr,
+            vec,
+            'c'
+        );
+        EXPECT_EQ(cap.indexed_size(), 6);
+        EXPECT_EQ(cap.named_size(), 1);
+
+        str = "XXXXX";
+        arr[0] = 100;
+        pt.x = 99;
+        vec[0] = 0;
+
+        const std::string expected = "hello 3.14 world (3, 4) [1, 2, 3] [7, 8]   c";
+        EXPECT_EQ(cap.format(), expected);
+
+        // Render on another thread
+        std::string result;
+        std::thread([&]()
+                    { result = cap.format(); })
+            .join();
+        EXPECT_EQ(result, expected);
+
+        format_capture moved = std::move(cap);
+        std::vector<char> buf;
+        moved.format_to(std::back_inserter(buf));
+        EXPECT_EQ(std::string_view(buf.data(), buf.size()), expected);
+    }
+
+    {
+        wformat_capture cap(L"{} {}", L"wide", 1);
+        EXPECT_EQ(cap.format(), L"wide 1");
+    }
+
+    {
+        format_capture cap("{}", 1);
+        EXPECT_THROW((void)format_capture(std::string_view("{} {}"), 1).format(), std::out_of_range);
+        EXPECT_EQ(cap.format(), "1");
+    }
+}
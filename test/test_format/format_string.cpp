@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <papilio/format.hpp>
+#include "test_format.hpp"
+#include <papilio_test/setup.hpp>
+
+TEST(format_string, segments)
+{
+    using namespace papilio;
+    using detail::fmt_segment_kind;
+
+    {
+        constexpr format_string<int, int> fmt("{} + {1}");
+        static_assert(fmt.segments().size() == 3);
+
+        const auto* it = fmt.segments().begin();
+        EXPECT_EQ(it[0].kind, fmt_segment_kind::automatic);
+        EXPECT_EQ(it[1].kind, fmt_segment_kind::literal);
+        EXPECT_EQ(it[1].offset, 2);
+        EXPECT_EQ(it[1].size, 3);
+        EXPECT_EQ(it[2].kind, fmt_segment_kind::indexed);
+        EXPECT_EQ(it[2].arg_id, 1);
+    }
+
+    {
+        constexpr format_string<double> fmt("{:*^+#12.3Lf}");
+        static_assert(fmt.segments().size() == 1);
+
+        const auto& seg = *fmt.segments().begin();
+        EXPECT_TRUE(seg.has_data);
+        EXPECT_EQ(seg.fill_size, 1);
+        EXPECT_EQ(seg.align, format_align::middle);
+        EXPECT_EQ(seg.sign, format_sign::positive);
+        EXPECT_TRUE(seg.alternate_form);
+        EXPECT_EQ(seg.width, 12);
+        EXPECT_EQ(seg.precision, 3);
+        EXPECT_TRUE(seg.use_locale);
+        EXPECT_EQ(seg.type, 'f');
+    }
+
+    {
+        constexpr format_string<int> fmt("{$ {0} > 1 ? 's'}");
+        static_assert(fmt.segments().size() == 1);
+        EXPECT_EQ(fmt.segments().begin()->kind, fmt_segment_kind::interpreted);
+    }
+
+    // Named arguments with names known at compile time are resolved to their slots
+    {
+        constexpr format_string<
+            static_named_arg<"a", int>,
+            int,
+            static_named_arg<"b", double>,
+            static_named_arg<"a", int>>
+            fmt("{b:.2f} {a:x}");
+        static_assert(fmt.segments().size() == 3);
+
+        const auto* it = fmt.segments().begin();
+        EXPECT_EQ(it[0].kind, fmt_segment_kind::named);
+        EXPECT_EQ(it[0].named_slot, 1);
+        EXPECT_TRUE(it[0].has_data);
+        EXPECT_EQ(it[2].named_slot, 2); // The last one wins
+
+        EXPECT_EQ(
+            PAPILIO_NS format("{b:.2f} {a:x} {}", "a"_a = 1, 2, "b"_a = 1.5, "a"_a = 255),
+            "1.50 ff 2"
+        );
+        EXPECT_EQ(
+            PAPILIO_NS format("{b:.2f} {a:x} {}", arg<"a">(1), 2, arg<"b">(1.5), arg<"a">(255)),
+            "1.50 ff 2"
+        );
+
+        // Arguments of the same string parsed at runtime
+        EXPECT_EQ(
+            PAPILIO_NS format(std::string_view("{b:.2f} {a:x} {}"), "a"_a = 1, 2, "b"_a = 1.5, "a"_a = 255),
+            "1.50 ff 2"
+        );
+    }
+
+    // Names only known at runtime are looked up when formatting
+    {
+        constexpr format_string<named_arg<int>> fmt("{a}");
+        EXPECT_EQ(fmt.segments().begin()->named_slot, std::numeric_limits<std::uint8_t>::max());
+        EXPECT_EQ(PAPILIO_NS format("{a}", arg("a", 1)), "1");
+    }
+
+    // Runtime strings will be parsed by the interpreter
+    {
+        const format_string<int> fmt(std::string_view("{}"));
+        EXPECT_TRUE(fmt.segments().empty());
+    }
+
+    // Fields separated by literal text are stored for any number of arguments
+    {
+        constexpr format_string<int, int, int, int, int> fmt("a={} b={} c={} d={} e={}");
+        static_assert(fmt.segments().size() == 10);
+
+        const auto* it = fmt.segments().begin();
+        EXPECT_EQ(it[0].kind, fmt_segment_kind::literal);
+        EXPECT_EQ(it[9].kind, fmt_segment_kind::automatic);
+
+        // A table with a wrong segment shows the parsed segments are used instead of the string
+        const detail::fmt_segment_table segments(it, 9);
+        EXPECT_EQ(
+            detail::vformat_impl(nullptr, fmt.get(), segments, PAPILIO_NS make_format_args(1, 2, 3, 4, 5)),
+            "a=1 b=2 c=3 d=4 e="
+        );
+        EXPECT_EQ(PAPILIO_NS format("a={} b={} c={} d={} e={}", 1, 2, 3, 4, 5), "a=1 b=2 c=3 d=4 e=5");
+    }
+
+    // Too many segments to be stored
+    {
+        constexpr format_string<int> fmt("{0}{0}{0}{0}{0}{0}{0}{0}{0}");
+        static_assert(fmt.segments().empty());
+
+        EXPECT_EQ(PAPILIO_NS format("{0}{0}{0}{0}{0}{0}{0}{0}{0}", 1), "111111111");
+    }
+
+    // Too long to be stored
+    {
+        constexpr format_string<int> fmt(
+            "{}                                                                              "
+            "                                                                                "
+            "                                                                                "
+            "                                                                                "
+        );
+        static_assert(fmt.segments().empty());
+    }
+
+    // Width out of the range of pre-parsed data
+    {
+        constexpr format_string<int> fmt("{:300}|");
+        static_assert(fmt.segments().size() == 2);
+        EXPECT_FALSE(fmt.segments().begin()->has_data);
+
+        EXPECT_EQ(PAPILIO_NS format("{:300}|", 1), std::string(299, ' ') + "1|");
+    }
+
+    // The format string should stay cheap to pass by value, and grow with the arguments
+    static_assert(sizeof(format_string<int>) <= 64);
+    static_assert(sizeof(format_string<int>) < sizeof(format_string<int, int, int, int, int>));
+}
+
+TYPED_TEST(format_suite, format_string)
+{
+    using namespace papilio;
+
+    using string_view_type = typename TestFixture::string_view_type;
+
+    // Results of strings parsed at compile time should be the same as the ones parsed at runtime.
+#define PAPILIO_CHECK_FORMAT_STRING(fmt, expected, ...)                                  \
+    do                                                                                   \
+    {                                                                                    \
+        const string_view_type fmt_sv = PAPILIO_TSTRING_VIEW(TypeParam, fmt);            \
+        EXPECT_EQ(PAPILIO_NS format(PAPILIO_TSTRING_ARRAY(TypeParam, fmt), __VA_ARGS__), \
+                  PAPILIO_NS format(fmt_sv, __VA_ARGS__));                               \
+        EXPECT_EQ(PAPILIO_NS format(PAPILIO_TSTRING_ARRAY(TypeParam, fmt), __VA_ARGS__), \
+                  PAPILIO_TSTRING_VIEW(TypeParam, expected));                            \
+    } while(0)
+
+    PAPILIO_CHECK_FORMAT_STRING("{} {}", "1 2", 1, 2);
+    PAPILIO_CHECK_FORMAT_STRING("{1} {0}", "2 1", 1, 2);
+    PAPILIO_CHECK_FORMAT_STRING("{:>8}|{:<4}|", "      42|abc |", 42, PAPILIO_TSTRING_ARRAY(TypeParam, "abc"));
+    PAPILIO_CHECK_FORMAT_STRING("{:#x} {:+08d}", "0xff +0000042", 255, 42);
+    PAPILIO_CHECK_FORMAT_STRING("{:c}{:?}", "A'b'", 65, TypeParam('b'));
+    PAPILIO_CHECK_FORMAT_STRING("{:.3f} {:e}", "3.142 1.000000e+00", 3.14159, 1.0);
+    PAPILIO_CHECK_FORMAT_STRING("{} {:d}", "true 1", true, true);
+    PAPILIO_CHECK_FORMAT_STRING("{:{}}", "  1", 1, 3);
+    PAPILIO_CHECK_FORMAT_STRING("{{{}}}", "{1}", 1);
+    PAPILIO_CHECK_FORMAT_STRING("{0.length:>3}", "  5", PAPILIO_TSTRING_VIEW(TypeParam, "hello"));
+    PAPILIO_CHECK_FORMAT_STRING("{} warning{$ {0} > 1 ? 's'}", "2 warnings", 2);
+
+#undef PAPILIO_CHECK_FORMAT_STRING
+
+    {
+        std::vector<TypeParam> result;
+        PAPILIO_NS format_to(
+            std::back_inserter(result),
+            PAPILIO_TSTRING_ARRAY(TypeParam, "[{name}: {value:.1f}]"),
+            PAPILIO_NS arg(PAPILIO_TSTRING_VIEW(TypeParam, "name"), 1),
+            PAPILIO_NS arg(PAPILIO_TSTRING_VIEW(TypeParam, "value"), 1.25)
+        );
+
+        EXPECT_EQ(
+            string_view_type(result.data(), result.size()),
+            PAPILIO_TSTRING_VIEW(TypeParam, "[1: 1.2]")
+        );
+    }
+}
+
+TEST(format_string, mutable_buffer)
+{
+    using namespace papilio;
+
+    {
+        char buf[16];
+        std::strcpy(buf, "{} x");
+
+        format_string<int> fmt(buf);
+        EXPECT_EQ(fmt.get(), "{} x");
+        EXPECT_TRUE(fmt.segments().empty());
+
+        EXPECT_EQ(PAPILIO_NS format(buf, 1), "1 x");
+    }
+
+    {
+        wchar_t buf[16] = L"{:>3}";
+        EXPECT_EQ(PAPILIO_NS format(buf, 1), L"  1");
+    }
+}
+
+namespace test_format
+{
+// Fails on looking up named arguments by their names
+class slot_only_format_args final : public papilio::format_args_base<papilio::format_context, char>
+{
+    using my_base = papilio::format_args_base<papilio::format_context, char>;
+
+public:
+    explicit slot_only_format_args(const my_base& args) noexcept
+        : m_args(args) {}
+
+    const format_arg_type& get(size_type i) const override
+    {
+        return m_args.get(i);
+    }
+
+    const format_arg_type& get(string_view_type) const override
+    {
+        throw std::logic_error("named argument looked up by name");
+    }
+
+    using my_base::get;
+
+    bool contains(string_view_type k) const noexcept override
+    {
+        return m_args.contains(k);
+    }
+
+    using my_base::contains;
+
+    size_type indexed_size() const noexcept override
+    {
+        return m_args.indexed_size();
+    }
+
+    size_type named_size() const noexcept override
+    {
+        return m_args.named_size();
+    }
+
+    const format_arg_type* get_named_at(size_type slot) const noexcept override
+    {
+        return m_args.get_named_at(slot);
+    }
+
+private:
+    const my_base& m_args;
+};
+} // namespace test_format
+
+TEST(format_string, named_slot)
+{
+    using namespace papilio;
+
+    constexpr format_string<
+        static_named_arg<"a", int>,
+        int,
+        static_named_arg<"b", double>>
+        fmt("{b:.2f} {a:x} {}");
+    static_assert(fmt.segments().size() == 5);
+
+    const auto args = PAPILIO_NS make_format_args("a"_a = 255, 2, "b"_a = 1.5);
+    const test_format::slot_only_format_args slot_args(args);
+
+    // Fields resolved at compile time should be read by their slots
+    EXPECT_EQ(
+        detail::vformat_impl(nullptr, fmt.get(), fmt.segments(), slot_args),
+        "1.50 ff 2"
+    );
+    // Fields of strings parsed at runtime are still looked up by names
+    EXPECT_THROW((void)PAPILIO_NS vformat("{a}", slot_args), std::logic_error);
+}
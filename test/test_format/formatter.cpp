@@ -56,6 +56,20 @@ TEST(fundamental_formatter, string)
     EXPECT_EQ(PAPILIO_NS format(L"{:>8.5}", L"hello!"), L"   hello");
     EXPECT_EQ(PAPILIO_NS format("{:*>8.5}", "hello!"), "***hello");
     EXPECT_EQ(PAPILIO_NS format(L"{:*>8.5}", L"hello!"), L"***hello");
+
+    EXPECT_EQ(PAPILIO_NS format("{:3}|", "hello"), "hello|");
+    EXPECT_EQ(PAPILIO_NS format(L"{:3}|", L"hello"), L"hello|");
+    EXPECT_EQ(PAPILIO_NS format("{:*^6}", "\u4e2d\u6587"), "*\u4e2d\u6587*");
+    EXPECT_EQ(PAPILIO_NS format(L"{:*^6}", L"\u4e2d\u6587"), L"*\u4e2d\u6587*");
+    EXPECT_EQ(PAPILIO_NS format("{:3}|", "\u4e2d\u6587"), "\u4e2d\u6587|");
+
+    // Strings wider than the field
+    {
+        const std::string long_str(1000, 'a');
+        EXPECT_EQ(PAPILIO_NS format("{:>10}", long_str), long_str);
+        EXPECT_EQ(PAPILIO_NS format("{:^20}", "\u4e2d" + long_str), "\u4e2d" + long_str);
+        EXPECT_EQ(PAPILIO_NS format("{:*^1004}", long_str), "**" + long_str + "**");
+    }
 }
 
 TEST(fundamental_formatter, bool)
@@ -170,6 +184,18 @@ TEST(fundamental_formatter, pointer)
     }
 }
 
+namespace test_format
+{
+enum class file_mode : unsigned int
+{
+    read = 1,
+    write = 2
+};
+} // namespace test_format
+
+template <>
+inline constexpr bool papilio::enable_enum_flags<test_format::file_mode> = true;
+
 TEST(fundamental_formatter, magic_enum)
 {
     using namespace papilio;
@@ -190,6 +216,20 @@ TEST(fundamental_formatter, magic_enum)
     EXPECT_EQ(PAPILIO_NS format(L"{}", dog), L"dog");
     EXPECT_EQ(PAPILIO_NS format(L"{:>5s}", dog), L"  dog");
 
+    // Values without names
+    EXPECT_EQ(PAPILIO_NS format("{}", static_cast<animal>(3)), "3");
+    EXPECT_EQ(PAPILIO_NS format("{:>3}", static_cast<animal>(3)), "  3");
+    EXPECT_EQ(PAPILIO_NS format(L"{}", static_cast<animal>(3)), L"3");
+
+    {
+        using test_format::file_mode;
+
+        EXPECT_EQ(PAPILIO_NS format("{}", file_mode::write), "write");
+        EXPECT_EQ(PAPILIO_NS format("{:>12}", static_cast<file_mode>(3)), "  read|write");
+        EXPECT_EQ(PAPILIO_NS format("{}", static_cast<file_mode>(4)), "4");
+        EXPECT_EQ(PAPILIO_NS format(L"{}", static_cast<file_mode>(3)), L"read|write");
+    }
+
 #endif
 
     EXPECT_EQ(PAPILIO_NS format("{:d}", cat), "1");
@@ -4,6 +4,7 @@
 #endif
 #include <papilio/format.hpp>
 #include <random>
+#include <charconv>
 #include "test_format.hpp"
 #include <papilio_test/setup.hpp>
 
@@ -75,6 +76,59 @@ TYPED_TEST(int_formatter_suite, random)
     }
 }
 
+TYPED_TEST(int_formatter_suite, digit_count_boundary)
+{
+    using namespace papilio;
+
+    // Compare with std::to_chars around the boundaries of the number of digits in every base
+    const auto check = [](TypeParam val)
+    {
+        char buf[128];
+
+        for(int base : {2, 8, 10, 16})
+        {
+            auto result = std::to_chars(buf, buf + 128, val, base);
+            std::string expected(buf, result.ptr);
+            std::string fmt;
+            switch(base)
+            {
+            case 2:
+                fmt = "{:b}";
+                break;
+            case 8:
+                fmt = "{:o}";
+                break;
+            case 16:
+                fmt = "{:x}";
+                break;
+            default:
+                fmt = "{}";
+                break;
+            }
+
+            EXPECT_EQ(PAPILIO_NS format(std::string_view(fmt), val), expected)
+                << "val = " << +val << ", base = " << base;
+        }
+    };
+
+    using limits = std::numeric_limits<TypeParam>;
+    for(int base : {2, 8, 10, 16})
+    {
+        for(unsigned long long p = 1; p <= static_cast<unsigned long long>(limits::max()) / static_cast<unsigned>(base); p *= static_cast<unsigned>(base))
+        {
+            for(unsigned long long v : {p - 1, p, p * base - 1, p * base})
+            {
+                check(static_cast<TypeParam>(v));
+                if constexpr(std::is_signed_v<TypeParam>)
+                    check(static_cast<TypeParam>(-static_cast<TypeParam>(v)));
+            }
+        }
+    }
+
+    check(limits::min());
+    check(limits::max());
+}
+
 TYPED_TEST(int_formatter_suite, extreme_value)
 {
     using namespace papilio;
@@ -188,6 +242,24 @@ std::locale attach_my_int_sep()
 {
     return std::locale(std::locale::classic(), new my_int_sep<CharT>());
 }
+
+template <typename CharT>
+class my_int_limited_sep : public std::numpunct<CharT>
+{
+public:
+    using char_type = typename std::numpunct<CharT>::char_type;
+
+protected:
+    char_type do_thousands_sep() const override
+    {
+        return char_type('.');
+    }
+
+    std::string do_grouping() const override
+    {
+        return std::string({'\2', std::numeric_limits<char>::max()});
+    }
+};
 } // namespace test_format
 
 TEST(int_formatter, locale)
@@ -221,4 +293,29 @@ TEST(int_formatter, locale)
             L"18.446.744.073.709.551.61.5"
         );
     }
+
+    // Empty grouping
+    {
+        EXPECT_EQ(PAPILIO_NS format(std::locale::classic(), "{:L}", 123456789), "123456789");
+        EXPECT_EQ(PAPILIO_NS format(std::locale::classic(), L"{:L}", 123456789), L"123456789");
+    }
+
+    // Unlimited group after the first one
+    {
+        std::locale loc(std::locale::classic(), new test_format::my_int_limited_sep<char>());
+
+        EXPECT_EQ(PAPILIO_NS format(loc, "{:L}", 123456789), "1234567.89");
+        EXPECT_EQ(PAPILIO_NS format(loc, "{:L}", -123456789), "-1234567.89");
+    }
+
+    // Switching between locales, including the ones destroyed after use
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            std::locale loc = test_format::attach_my_int_sep();
+
+            EXPECT_EQ(PAPILIO_NS format(loc, "{:L}", 1234), "1.23.4");
+            EXPECT_EQ(PAPILIO_NS format(loc, "{:d}", 1234), "1234");
+        }
+    }
 }
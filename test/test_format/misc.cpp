@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <vector>
 #include <papilio/format.hpp>
 #include <papilio/print.hpp>
 #include <papilio/formatter/misc.hpp>
@@ -33,6 +34,38 @@ TEST(stream_adaptor, stream_adaptor)
     }
 }
 
+TEST(stream_adaptor, long_output)
+{
+    using namespace papilio;
+    using test_format::stream_chunks;
+
+    {
+        const std::string expected = stream_chunks::expected<char>();
+
+        EXPECT_EQ(PAPILIO_NS format("{}", stream_chunks{}), expected);
+        EXPECT_EQ(PAPILIO_NS formatted_size("{}", stream_chunks{}), expected.size());
+        EXPECT_EQ(
+            PAPILIO_NS format("{:*^{}}", stream_chunks{}, expected.size() + 4),
+            "**" + expected + "**"
+        );
+
+        std::string buf(300, '\0');
+        auto result = PAPILIO_NS format_to_n(buf.begin(), buf.size(), "{}", stream_chunks{});
+        EXPECT_EQ(result.out, buf.end());
+        EXPECT_EQ(buf, expected.substr(0, 300));
+    }
+
+    {
+        const std::wstring expected = stream_chunks::expected<wchar_t>();
+
+        EXPECT_EQ(PAPILIO_NS format(L"{}", stream_chunks{}), expected);
+        EXPECT_EQ(
+            PAPILIO_NS format(L"{:<{}}", stream_chunks{}, expected.size() + 2),
+            expected + L"  "
+        );
+    }
+}
+
 // Reported by KKoishi_
 TEST(stream_adaptor, bad_spec)
 {
@@ -94,6 +127,15 @@ TEST(misc_formatter, join)
             L"01 | 02 | 03 | 04"
         );
     }
+
+    {
+        std::vector<int> vec(100000, 1);
+
+        char buf[8]{};
+        auto result = PAPILIO_NS format_to_n(buf, 5, "{}", PAPILIO_NS join(vec, ","));
+        EXPECT_EQ(result.size, 5);
+        EXPECT_STREQ(buf, "1,1,1");
+    }
 }
 
 TEST(misc_formatter, thread_id)
@@ -3,6 +3,9 @@
 #include <list>
 #include <set>
 #include <ranges>
+#include <span>
+#include <limits>
+#include <cstdint>
 #include <papilio/format.hpp>
 #include "test_format.hpp"
 #include <papilio_test/setup.hpp>
@@ -182,3 +185,81 @@ TEST(ranges, nested)
         EXPECT_EQ(PAPILIO_NS format(L"{}", v), L"[[1, 2], [3, 4, 5], [6]]");
     }
 }
+
+TEST(ranges, contiguous_arithmetic)
+{
+    using namespace papilio;
+
+    static_assert(formatter_traits<formatter<int>>::has_format_range<int, format_context>());
+    static_assert(formatter_traits<formatter<double>>::has_format_range<double, format_context>());
+    static_assert(!formatter_traits<formatter<bool>>::has_format_range<bool, format_context>());
+    // Formatters derived from the building blocks may customize the formatting of a single value
+    static_assert(!formatter_traits<float_formatter<double, char>>::has_format_range<double, format_context>());
+
+    {
+        std::vector<int> vec{-12, 0, 255, 1000};
+
+        EXPECT_EQ(PAPILIO_NS format("{}", vec), "[-12, 0, 255, 1000]");
+        EXPECT_EQ(PAPILIO_NS format("{::+}", vec), "[-12, +0, +255, +1000]");
+        EXPECT_EQ(PAPILIO_NS format("{::#X}", vec), "[-0XC, 0X0, 0XFF, 0X3E8]");
+        EXPECT_EQ(PAPILIO_NS format("{::#o}", vec), "[-014, 00, 0377, 01750]");
+        EXPECT_EQ(PAPILIO_NS format("{:n:_>5}", vec), "__-12, ____0, __255, _1000");
+        EXPECT_EQ(PAPILIO_NS format("{::c}", std::vector<int>{'a', 'b'}), "[a, b]");
+        EXPECT_EQ(PAPILIO_NS format(L"{::x}", vec), L"[-c, 0, ff, 3e8]");
+
+        const int arr[3] = {1, 2, 3};
+        EXPECT_EQ(PAPILIO_NS format("{}", arr), "[1, 2, 3]");
+        EXPECT_EQ(PAPILIO_NS format("{}", std::span<const int>()), "[]");
+    }
+
+    {
+        std::vector<double> vec{
+            1.5,
+            -0.0,
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::quiet_NaN()
+        };
+
+        EXPECT_EQ(PAPILIO_NS format("{}", vec), "[1.5, -0, inf, -nan]");
+        EXPECT_EQ(PAPILIO_NS format("{::+.2F}", vec), "[+1.50, -0.00, +INF, -NAN]");
+        EXPECT_EQ(PAPILIO_NS format(L"{}", vec), L"[1.5, -0, inf, -nan]");
+
+        // Too long for the buffer of a single value
+        const std::vector<double> large{1e300, 2.0};
+        EXPECT_EQ(
+            PAPILIO_NS format("{::f}", large),
+            PAPILIO_NS format("[{:f}, {:f}]", large[0], large[1])
+        );
+    }
+
+    // Results crossing the blocks of the buffer
+    {
+        std::vector<std::int64_t> vec;
+        std::vector<float> fvec;
+        std::string expected = "[";
+        std::string fexpected = "[";
+        for(int i = 0; i < 2000; ++i)
+        {
+            vec.push_back(std::int64_t(i) * 1234567891011 - 5000);
+            fvec.push_back(static_cast<float>(i) / 3.0f);
+
+            if(i != 0)
+            {
+                expected += ", ";
+                fexpected += ", ";
+            }
+            expected += PAPILIO_NS format("{}", vec.back());
+            fexpected += PAPILIO_NS format("{}", fvec.back());
+        }
+        expected += ']';
+        fexpected += ']';
+
+        EXPECT_EQ(PAPILIO_NS format("{}", vec), expected);
+        EXPECT_EQ(PAPILIO_NS format("{}", fvec), fexpected);
+        EXPECT_EQ(PAPILIO_NS formatted_size("{}", vec), expected.size());
+
+        std::string buf(100, '\0');
+        PAPILIO_NS format_to_n(buf.begin(), buf.size(), "{}", vec);
+        EXPECT_EQ(buf, expected.substr(0, 100));
+    }
+}
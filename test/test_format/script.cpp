@@ -129,6 +129,27 @@ TYPED_TEST(format_suite, script_branch)
     }
 }
 
+TYPED_TEST(format_suite, script_escape)
+{
+    using namespace papilio;
+
+    using string_view_type = typename TestFixture::string_view_type;
+
+    string_view_type script =
+        PAPILIO_TSTRING_VIEW(TypeParam, "{$ {}? 'it\\'s\\n' : 'no\\tway'}!");
+
+    // Escaped literals are written by the interpreter when the cache is disabled
+    for(bool cache : {false, true})
+    {
+        script_base::enable_script_cache(cache);
+
+        EXPECT_EQ(PAPILIO_NS format(script, true), PAPILIO_TSTRING_VIEW(TypeParam, "it's\n!"))
+            << "cache = " << cache;
+        EXPECT_EQ(PAPILIO_NS format(script, false), PAPILIO_TSTRING_VIEW(TypeParam, "no\tway!"))
+            << "cache = " << cache;
+    }
+}
+
 TYPED_TEST(format_suite, script_composite)
 {
     using namespace papilio;
@@ -19,6 +19,34 @@ public:
     friend std::wostream& operator<<(std::wostream& os, const stream_only&);
 };
 
+// Writes characters and strings of different lengths
+class stream_chunks
+{
+public:
+    template <typename CharT>
+    friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, stream_chunks)
+    {
+        for(int i = 0; i < 100; ++i)
+        {
+            os.put(static_cast<CharT>('0' + i % 10));
+            os << std::basic_string<CharT>(static_cast<std::size_t>(i * 7 % 300), static_cast<CharT>('a' + i % 26));
+        }
+        return os;
+    }
+
+    template <typename CharT>
+    static std::basic_string<CharT> expected()
+    {
+        std::basic_string<CharT> result;
+        for(int i = 0; i < 100; ++i)
+        {
+            result += static_cast<CharT>('0' + i % 10);
+            result.append(static_cast<std::size_t>(i * 7 % 300), static_cast<CharT>('a' + i % 26));
+        }
+        return result;
+    }
+};
+
 class format_disabled
 {
 public:
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <vector>
 #include <papilio/locale.hpp>
 #include <papilio_test/setup.hpp>
 
@@ -18,6 +19,26 @@ protected:
     }
 };
 
+// Punctuation like the de_DE locale
+class comma_numpunct : public std::numpunct<char>
+{
+protected:
+    char do_decimal_point() const override
+    {
+        return ',';
+    }
+
+    char do_thousands_sep() const override
+    {
+        return '.';
+    }
+
+    std::string do_grouping() const override
+    {
+        return "\3";
+    }
+};
+
 static std::string bool_to_string(bool value, const std::locale& loc)
 {
     const auto& f = std::use_facet<std::numpunct<char>>(loc);
@@ -55,6 +76,65 @@ TEST(locale, locale_ref)
     }
 }
 
+TEST(locale, get_locale_punct)
+{
+    using namespace papilio;
+    using namespace test_locale;
+
+    for(int i = 0; i < 3; ++i)
+    {
+        const auto& punct = detail::get_locale_punct<char>(std::locale::classic());
+        EXPECT_EQ(punct.decimal_point, '.');
+        EXPECT_EQ(punct.thousands_sep, ',');
+        EXPECT_EQ(punct.grouping, "");
+    }
+
+    {
+        std::locale comma(std::locale::classic(), new comma_numpunct);
+
+        // Cached on the second call
+        for(int i = 0; i < 3; ++i)
+        {
+            const auto& punct = detail::get_locale_punct<char>(comma);
+            EXPECT_EQ(punct.decimal_point, ',');
+            EXPECT_EQ(punct.thousands_sep, '.');
+            EXPECT_EQ(punct.grouping, "\3");
+        }
+
+        // Returned from the cache without copying
+        EXPECT_EQ(
+            &detail::get_locale_punct<char>(comma),
+            &detail::get_locale_punct<char>(comma)
+        );
+
+        const auto& wpunct = detail::get_locale_punct<wchar_t>(comma);
+        EXPECT_EQ(wpunct.decimal_point, L'.');
+    }
+
+    // More locales than cached entries, including the ones destroyed after use
+    for(int round = 0; round < 3; ++round)
+    {
+        std::vector<std::locale> locales;
+        for(int i = 0; i < 8; ++i)
+        {
+            locales.emplace_back(
+                std::locale::classic(),
+                i % 2 == 0 ? static_cast<std::numpunct<char>*>(new comma_numpunct) : new my_numpunct
+            );
+        }
+
+        for(int repeat = 0; repeat < 2; ++repeat)
+        {
+            for(std::size_t i = 0; i < locales.size(); ++i)
+            {
+                const auto& punct = detail::get_locale_punct<char>(locales[i]);
+                EXPECT_EQ(punct.decimal_point, i % 2 == 0 ? ',' : '.');
+                EXPECT_EQ(punct.grouping, i % 2 == 0 ? "\3" : "");
+            }
+        }
+    }
+}
+
 int main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include <cstdio>
+#include <thread>
+#include <vector>
 #include <papilio/print.hpp>
 #if defined PAPILIO_PLATFORM_LINUX
 #    ifndef _GNU_SOURCE
@@ -62,6 +64,70 @@ TEST(print, tmpfile)
     EXPECT_EQ(std::string_view(buf, 10), "test\ntest\n");
 }
 
+namespace test_print
+{
+// Prints a log line when being formatted
+struct logged_value
+{
+    std::FILE* log;
+    int value;
+};
+} // namespace test_print
+
+namespace papilio
+{
+template <typename CharT>
+struct formatter<test_print::logged_value, CharT>
+{
+    template <typename ParseContext>
+    auto parse(ParseContext& ctx) -> typename ParseContext::iterator
+    {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const test_print::logged_value& val, FormatContext& ctx) const
+        -> typename FormatContext::iterator
+    {
+        PAPILIO_NS println(val.log, "formatting {}", val.value);
+        return PAPILIO_NS format_to(ctx.out(), "{}", val.value);
+    }
+};
+} // namespace papilio
+
+TEST(print, nested)
+{
+    using namespace papilio;
+
+    std::FILE* fp = std::tmpfile();
+    if(!fp)
+        GTEST_SKIP();
+    std::FILE* log = std::tmpfile();
+    if(!log)
+    {
+        std::fclose(fp);
+        GTEST_SKIP();
+    }
+
+    PAPILIO_NS println(fp, "value = {}", test_print::logged_value{log, 42});
+    PAPILIO_NS println(fp, "done");
+    fflush(fp);
+    fflush(log);
+
+    char buf[32]{};
+
+    ASSERT_EQ(fseek(fp, 0, SEEK_SET), 0);
+    size_t len = fread(buf, sizeof(char), 16, fp);
+    EXPECT_EQ(std::string_view(buf, len), "value = 42\ndone\n");
+
+    ASSERT_EQ(fseek(log, 0, SEEK_SET), 0);
+    len = fread(buf, sizeof(char), 16, log);
+    EXPECT_EQ(std::string_view(buf, len), "formatting 42\n");
+
+    std::fclose(fp);
+    std::fclose(log);
+}
+
 TEST(print, file_stdout)
 {
     using namespace papilio;
@@ -169,6 +235,137 @@ TEST(print, styled)
     }
 }
 
+namespace test_print
+{
+// Reads the whole content of a temporary file
+std::string read_all(std::FILE* fp)
+{
+    std::fflush(fp);
+    std::string result;
+    if(std::fseek(fp, 0, SEEK_SET) != 0)
+        return result;
+
+    char buf[256];
+    std::size_t len;
+    while((len = std::fread(buf, 1, sizeof(buf), fp)) != 0)
+        result.append(buf, len);
+    return result;
+}
+
+std::vector<std::string> split_lines(std::string_view str)
+{
+    std::vector<std::string> result;
+    while(!str.empty())
+    {
+        std::size_t pos = str.find('\n');
+        result.emplace_back(str.substr(0, pos));
+        if(pos == str.npos)
+            break;
+        str.remove_prefix(pos + 1);
+    }
+    return result;
+}
+} // namespace test_print
+
+TEST(print, async_sink)
+{
+    using namespace papilio;
+
+    std::FILE* fp = std::tmpfile();
+    if(!fp)
+        GTEST_SKIP();
+
+    {
+        async_sink sink(fp);
+        sink.println("{} {}", "hello", 42);
+        sink.print("{:>4}", "a");
+        sink.println("{}", "b");
+        sink.flush();
+
+        EXPECT_EQ(test_print::read_all(fp), "hello 42\n   ab\n");
+
+        sink.println("before destruction");
+    }
+
+    EXPECT_EQ(test_print::read_all(fp), "hello 42\n   ab\nbefore destruction\n");
+
+    std::fclose(fp);
+}
+
+TEST(print, async_sink_threads)
+{
+    using namespace papilio;
+
+    constexpr int thread_count = 4;
+    constexpr int line_count = 1000;
+
+    auto produce = [](async_sink& sink)
+    {
+        std::vector<std::thread> threads;
+        for(int i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back(
+                [&sink, i]()
+                {
+                    for(int j = 0; j < line_count; ++j)
+                        sink.println("{} {}", i, j);
+                }
+            );
+        }
+        for(auto& t : threads)
+            t.join();
+        sink.flush();
+    };
+
+    // Lines of each thread keep their order
+    for(auto policy : {async_sink::overflow_policy::block, async_sink::overflow_policy::grow})
+    {
+        std::FILE* fp = std::tmpfile();
+        if(!fp)
+            GTEST_SKIP();
+
+        // The file must remain valid until the sink is destroyed
+        {
+            async_sink sink(fp, 16, policy);
+            produce(sink);
+            EXPECT_EQ(sink.dropped(), 0);
+        }
+
+        std::vector<std::string> lines = test_print::split_lines(test_print::read_all(fp));
+        ASSERT_EQ(lines.size(), thread_count * line_count);
+
+        int next[thread_count]{};
+        for(const std::string& l : lines)
+        {
+            int i = l[0] - '0';
+            ASSERT_TRUE(0 <= i && i < thread_count) << l;
+            EXPECT_EQ(l, PAPILIO_NS format("{} {}", i, next[i]));
+            ++next[i];
+        }
+
+        std::fclose(fp);
+    }
+
+    // Dropped lines are counted
+    {
+        std::FILE* fp = std::tmpfile();
+        if(!fp)
+            GTEST_SKIP();
+
+        std::size_t dropped = 0;
+        {
+            async_sink sink(fp, 2, async_sink::overflow_policy::drop);
+            produce(sink);
+            dropped = sink.dropped();
+        }
+
+        std::size_t written = test_print::split_lines(test_print::read_all(fp)).size();
+        EXPECT_EQ(written + dropped, thread_count * line_count);
+
+        std::fclose(fp);
+    }
+}
+
 int main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
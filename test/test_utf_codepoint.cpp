@@ -181,6 +181,70 @@ TEST(codepoint, estimate_width)
         codepoint cjk_6587 = U'\u6587'_cp;
         EXPECT_EQ(cjk_6587.estimate_width(), 2);
     }
+
+    static_assert(utf::estimate_width(U'a') == 1);
+    static_assert(utf::estimate_width(U'\u6587') == 2);
+
+    // Compare with the intervals of wide code points
+    {
+        constexpr std::pair<char32_t, char32_t> wide_intervals[] = {
+            { 0x1100u,  0x1160u},
+            { 0x2329u,  0x232Bu},
+            { 0x2E80u,  0x303Fu},
+            { 0x3040u,  0xA4D0u},
+            { 0xAC00u,  0xD7A4u},
+            { 0xF900u,  0xFB00u},
+            { 0xFE10u,  0xFE1Au},
+            { 0xFE30u,  0xFE70u},
+            { 0xFF00u,  0xFF61u},
+            { 0xFFE0u,  0xFFE7u},
+            {0x1F300u, 0x1F650u},
+            {0x1F900u, 0x1FA00u},
+            {0x20000u, 0x2FFFEu},
+            {0x30000u, 0x3FFFEu}
+        };
+
+        for(char32_t ch = 0; ch <= 0x10FFFF; ++ch)
+        {
+            std::size_t expected = 1;
+            for(const auto& [begin, end] : wide_intervals)
+            {
+                if(begin <= ch && ch < end)
+                    expected = 2;
+            }
+
+            ASSERT_EQ(utf::estimate_width(ch), expected) << "ch = " << static_cast<std::uint32_t>(ch);
+        }
+    }
+}
+
+TYPED_TEST(codepoint_suite, estimate_width)
+{
+    using namespace papilio;
+    using namespace utf;
+
+    using string_view_type = std::basic_string_view<TypeParam>;
+
+    EXPECT_EQ(utf::estimate_width(string_view_type()), 0);
+    EXPECT_EQ(utf::estimate_width(PAPILIO_TSTRING_VIEW(TypeParam, "hello")), 5);
+
+    // Long enough for processing ASCII by blocks
+    EXPECT_EQ(
+        utf::estimate_width(PAPILIO_TSTRING_VIEW(TypeParam, "The quick brown fox jumps over the lazy dog.")),
+        44
+    );
+
+    {
+        const auto str = PAPILIO_TSTRING_ARRAY(TypeParam, "\u00c4\u4e00 |\U0001f351| abcdefghijklmnopqrstuvwxyz \u6587");
+        EXPECT_EQ(utf::estimate_width(string_view_type(str)), 38);
+
+        // Stopping early
+        EXPECT_EQ(utf::estimate_width(string_view_type(str), 100), 38);
+        EXPECT_EQ(utf::estimate_width(string_view_type(str), 38), 38);
+        EXPECT_GE(utf::estimate_width(string_view_type(str), 10), 10);
+        EXPECT_LT(utf::estimate_width(string_view_type(str), 10), 38);
+        EXPECT_EQ(utf::estimate_width(string_view_type(str), 0), 0);
+    }
 }
 
 TYPED_TEST(codepoint_suite, ostream)
@@ -145,6 +145,19 @@ TEST(named_arg, named_arg)
         const auto a_1 = "integer"_a = int_val;
         EXPECT_EQ(a_1.name, "integer");
         EXPECT_EQ(a_1.value, int_val);
+
+        static_assert(std::same_as<decltype(a_1), const papilio::static_named_arg<"integer", const int>>);
+        static_assert(decltype(a_1)::static_name == "integer");
+    }
+
+    {
+        using namespace papilio;
+
+        const float float_val = 1.5f;
+        const auto a_2 = arg<L"float">(float_val);
+        static_assert(is_named_arg_v<std::remove_cvref_t<decltype(a_2)>>);
+        EXPECT_EQ(a_2.name, L"float");
+        EXPECT_EQ(&a_2.get(), &float_val);
     }
 }
 
@@ -390,6 +403,83 @@ TEST(enum_name, enum_name)
     EXPECT_EQ(enum_name(second), "second");
     EXPECT_EQ(enum_name(my_enum_class::one), "one");
     EXPECT_EQ(enum_name(my_enum_class::two), "two");
+
+    static_assert(static_enum_name<static_cast<my_enum_class>(3)>().empty());
+    EXPECT_EQ(enum_name(static_cast<my_enum_class>(3)), "");
+    EXPECT_EQ(enum_name(static_cast<my_enum_class>(1000)), "");
+}
+
+namespace test_utility
+{
+enum class sparse_enum : int
+{
+    low = -1000,
+    mid = 0,
+    high = 1000
+};
+
+enum class flag_enum : std::uint32_t
+{
+    none = 0,
+    read = 1,
+    write = 2,
+    exec = 4,
+    sign = 0x80000000
+};
+} // namespace test_utility
+
+template <>
+struct papilio::enum_range<test_utility::sparse_enum>
+{
+    static constexpr std::int64_t min = -1000;
+    static constexpr std::int64_t max = 1000;
+};
+
+template <>
+inline constexpr bool papilio::enable_enum_flags<test_utility::flag_enum> = true;
+
+TEST(enum_name, enum_range)
+{
+    using namespace papilio;
+    using test_utility::sparse_enum;
+
+    static_assert(!detail::enum_entries_dense<sparse_enum>);
+    static_assert(detail::enum_entries<sparse_enum>.size() == 3);
+
+    static_assert(enum_name(sparse_enum::low) == "low");
+    EXPECT_EQ(enum_name(sparse_enum::low), "low");
+    EXPECT_EQ(enum_name(sparse_enum::mid), "mid");
+    EXPECT_EQ(enum_name(sparse_enum::high), "high");
+    EXPECT_EQ(enum_name(static_cast<sparse_enum>(1)), "");
+    EXPECT_EQ(enum_name(static_cast<sparse_enum>(2000)), "");
+
+    enum contiguous
+    {
+        a = 10,
+        b,
+        c
+    };
+
+    static_assert(detail::enum_entries_dense<contiguous>);
+    EXPECT_EQ(enum_name(b), "b");
+    EXPECT_EQ(enum_name(static_cast<contiguous>(9)), "");
+    EXPECT_EQ(enum_name(static_cast<contiguous>(13)), "");
+}
+
+TEST(enum_name, enum_flags)
+{
+    using namespace papilio;
+    using test_utility::flag_enum;
+
+    EXPECT_EQ(enum_name(flag_enum::none), "none");
+    EXPECT_EQ(enum_name(flag_enum::sign), "sign");
+    EXPECT_EQ(enum_name(static_cast<flag_enum>(3)), "");
+
+    EXPECT_EQ(enum_flags_name(flag_enum::write), "write");
+    EXPECT_EQ(enum_flags_name(static_cast<flag_enum>(3)), "read|write");
+    EXPECT_EQ(enum_flags_name(static_cast<flag_enum>(0x80000005), " | "), "read | exec | sign");
+    EXPECT_EQ(enum_flags_name(static_cast<flag_enum>(8)), "");
+    EXPECT_EQ(enum_flags_name(static_cast<flag_enum>(9)), "");
 }
 
 #endif